@@ -4,26 +4,47 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../chacha20.c \
 ../door_locker_security_system_mc1.c \
+../format.c \
 ../gpio.c \
+../hmi_screen.c \
+../hmi_text.c \
 ../keypad.c \
 ../lcd.c \
+../lcd_framebuffer.c \
+../link.c \
+../poly1305.c \
 ../timer.c \
 ../uart.c 
 
 OBJS += \
+./chacha20.o \
 ./door_locker_security_system_mc1.o \
+./format.o \
 ./gpio.o \
+./hmi_screen.o \
+./hmi_text.o \
 ./keypad.o \
 ./lcd.o \
+./lcd_framebuffer.o \
+./link.o \
+./poly1305.o \
 ./timer.o \
 ./uart.o 
 
 C_DEPS += \
+./chacha20.d \
 ./door_locker_security_system_mc1.d \
+./format.d \
 ./gpio.d \
+./hmi_screen.d \
+./hmi_text.d \
 ./keypad.d \
 ./lcd.d \
+./lcd_framebuffer.d \
+./link.d \
+./poly1305.d \
 ./timer.d \
 ./uart.d 
 
@@ -32,7 +53,7 @@ C_DEPS += \
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -Os -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -0,0 +1,172 @@
+/****************************************************************************************
+ *
+ * Module: ChaCha20
+ *
+ * File Name: chacha20.c
+ *
+ * Discretion: Source file for the ChaCha20 block function (RFC 8439)
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "chacha20.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*
+ * Quarter round. ChaCha only adds, XORs and rotates 32-bit words, and two of its four rotations
+ * (16 and 8) are whole bytes, which suits the 8-bit AVR better than a cipher with tables or multiplications.
+ */
+#define CHACHA20_QUARTER_ROUND(a, b, c, d)						\
+	do{															\
+		(a) += (b); (d) ^= (a); (d) = CHACHA20_rotl((d), 16);	\
+		(c) += (d); (b) ^= (c); (b) = CHACHA20_rotl((b), 12);	\
+		(a) += (b); (d) ^= (a); (d) = CHACHA20_rotl((d), 8);	\
+		(c) += (d); (b) ^= (c); (b) = CHACHA20_rotl((b), 7);	\
+	}while(0)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* "expand 32-byte k" */
+static const uint32 g_chacha20Constants[4] PROGMEM =
+{
+	0x61707865, 0x3320646E, 0x79622D32, 0x6B206574
+};
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Return one word of the block input: constants, key, counter then nonce.
+ */
+static uint32 CHACHA20_inputWord(const uint8 *a_key_ptr, const uint8 *a_nonce_ptr, uint32 counter, uint8 index);
+
+/*
+ * Description:
+ * Read a little endian word.
+ */
+static uint32 CHACHA20_load32(const uint8 *a_data_ptr);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Rotate left by a constant. A 32-bit shift by n is a loop of n 1-bit shifts of 4 bytes on the AVR,
+ * so the whole bytes are moved (register moves only) and at most 4 single bit rotations are left:
+ * 12 = 16 - 4 and 7 = 8 - 1.
+ */
+static inline __attribute__((always_inline)) uint32 CHACHA20_rotl(uint32 x, uint8 n)
+{
+	uint8 bytes = n >> 3;
+	uint8 bits = n & 7;
+	uint8 right = FALSE;
+
+	if(bits > 3)
+	{
+		bytes++;
+		bits = 8 - bits;
+		right = TRUE;
+	}
+
+	switch(bytes & 3)
+	{
+	case 1:
+		x = (x << 8) | (x >> 24);
+		break;
+	case 2:
+		x = (x << 16) | (x >> 16);
+		break;
+	case 3:
+		x = (x << 24) | (x >> 8);
+		break;
+	default:
+		break;
+	}
+
+	while(bits != 0)
+	{
+		x = right ? ((x >> 1) | (x << 31)) : ((x << 1) | (x >> 31));
+		bits--;
+	}
+	return x;
+}
+
+/*
+ * Description:
+ * Write the 64 bytes of key stream of one block for the key, the nonce and the block counter.
+ * A key and nonce pair must never be used again with the same counter.
+ */
+void CHACHA20_block(const uint8 *a_key_ptr, const uint8 *a_nonce_ptr, uint32 counter, uint8 *a_output_ptr)
+{
+	uint32 x[16];
+	uint32 word;
+	uint8 i;
+
+	for(i = 0; i < 16; i++)
+	{
+		x[i] = CHACHA20_inputWord(a_key_ptr, a_nonce_ptr, counter, i);
+	}
+
+	/* 20 rounds: a column round and a diagonal round at each pass. */
+	for(i = 0; i < 10; i++)
+	{
+		CHACHA20_QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+		CHACHA20_QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+		CHACHA20_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+		CHACHA20_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+		CHACHA20_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+		CHACHA20_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+		CHACHA20_QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+		CHACHA20_QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+	}
+
+	/* The input is read again for the final addition instead of keeping a second copy of 64 bytes. */
+	for(i = 0; i < 16; i++)
+	{
+		word = x[i] + CHACHA20_inputWord(a_key_ptr, a_nonce_ptr, counter, i);
+		a_output_ptr[0] = (uint8)word;
+		a_output_ptr[1] = (uint8)(word >> 8);
+		a_output_ptr[2] = (uint8)(word >> 16);
+		a_output_ptr[3] = (uint8)(word >> 24);
+		a_output_ptr += 4;
+	}
+}
+
+/*
+ * Description:
+ * Return one word of the block input: constants, key, counter then nonce.
+ */
+static uint32 CHACHA20_inputWord(const uint8 *a_key_ptr, const uint8 *a_nonce_ptr, uint32 counter, uint8 index)
+{
+	if(index < 4)
+	{
+		return pgm_read_dword(&g_chacha20Constants[index]);
+	}
+	if(index < 12)
+	{
+		return CHACHA20_load32(&a_key_ptr[(index - 4) << 2]);
+	}
+	if(index == 12)
+	{
+		return counter;
+	}
+	return CHACHA20_load32(&a_nonce_ptr[(index - 13) << 2]);
+}
+
+/*
+ * Description:
+ * Read a little endian word.
+ */
+static uint32 CHACHA20_load32(const uint8 *a_data_ptr)
+{
+	return ((uint32)a_data_ptr[3] << 24) | ((uint32)a_data_ptr[2] << 16) | ((uint16)a_data_ptr[1] << 8) | a_data_ptr[0];
+}
@@ -0,0 +1,38 @@
+/****************************************************************************************
+ *
+ * Module: ChaCha20
+ *
+ * File Name: chacha20.h
+ *
+ * Discretion: Header file for the ChaCha20 block function (RFC 8439)
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef CHACHA20_H_
+#define CHACHA20_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define CHACHA20_KEY_SIZE				32			/* Bytes of the key. */
+#define CHACHA20_NONCE_SIZE				12			/* Bytes of the nonce. */
+#define CHACHA20_BLOCK_SIZE				64			/* Bytes of key stream made by each block. */
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Write the 64 bytes of key stream of one block for the key, the nonce and the block counter.
+ * A key and nonce pair must never be used again with the same counter.
+ */
+void CHACHA20_block(const uint8 *a_key_ptr, const uint8 *a_nonce_ptr, uint32 counter, uint8 *a_output_ptr);
+
+#endif /* CHACHA20_H_ */
@@ -4,22 +4,26 @@
  Author      : Abdelrahman Ehab
  Description : A door is locked by a password.
  	 	 	   If you write the password correctly the door will open.
-  	  	  	   when you enter the password 3 times wrong, the buzzer will be activated for 1 minute.
+  	  	  	   when you enter the password 3 times wrong, the door is locked by MC2 for 1 minute (longer for each next lockout).
  Date        : 1/11/2021
  ================================================================================================
  */
 
-/* Change CPU frequency to 8000000 */
-#define F_CPU 8000000UL
-
 /*******************************************************************************
  *                    	     	Include Header	                               *
  *******************************************************************************/
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include <util/delay.h>
+#include <avr/pgmspace.h>
 #include "keypad.h"
 #include "lcd.h"
+#include "format.h"
+#include "hmi_screen.h"
+#include "hmi_text.h"
+#include "lcd_framebuffer.h"
+#include "link.h"
+#include "ring_buffer.h"
+#include "sync.h"
 #include "uart.h"
 #include "timer.h"
 
@@ -30,16 +34,24 @@
 #define MC2_READY 							0x01 		/* Handshaking between MC1 and MC2 (if use pooling instead of interrupt in UART). */
 
 #define ENTER  								13   		/* For the enter button. */
+#define ENTER_4X3							'+'			/* The 4x3 keypad has no enter button, its '#' key (read as '+') ends the password too. */
 
 #define PASSWORD_SIZE						4	 		/* To set the password size with a name. */
-#define MAX_NUMBER_OF_ERRORS				3			/* This is the number of times available for the user to write the password wrong before the buzzer get activated. */
 
-#define TIMER_OPEN_CLOSE_DOOR				233	 		/* This is the number of overflow required to make 15 seconds. */
-#define TIMER_HOLD_DOOR						46			/* This is the number of overflow required to make 3 seconds. */
-#define TIMER_BUZZER						930			/* This is the number of overflow required to make 60 seconds. */
+/* Timer0 interrupts every 1 ms (TIMER_TICK_COMPARE_VALUE in timer.h), all times below are in ms. */
+#define TIMER_MESSAGE						1000		/* Time of presenting a message on the screen (1 second). */
+#define TIMER_SHORT_MESSAGE					500			/* Time of presenting wrong password message on the screen (0.5 second). */
+#define TIMER_DOOR_STATUS					250			/* Time between asking MC2 about the door state while the door is moving. */
+#define TIMER_LOCKOUT_STATUS				1000		/* Time between asking MC2 about the seconds left of the lockout. */
+#define TIMER_PASSWORD_STATUS				1000		/* Time between asking MC2 if a password is saved until it answers. */
+#define TIMER_WAIT_REPLY					2000		/* Longest time for MC2 to answer a password, the link or MC2 is down after it. */
+#define TIMER_CHANGE_PASSWORD				55000		/* Time to write the new password after CORRECT_PASSWORD, MC2 drops the change after 60 seconds. */
 
 /* Commands for making MC1 and MC2 can communicate with each other */
-#define FIRST_PASSWORD						0xF1 		/* This used to inform MC2 that the first password will be created by sending password data for the first time to MC2 from MC1. */
+#define DOOR_IN_FAULT						0xEE		/* The password is correct but the door is stopped by a fault. */
+#define CLEAR_FAULT							0xEF		/* Ask MC2 to close the door in fault again, MC2 answers with one of the door states below. */
+#define DOOR_BUSY							0xF0		/* The password is correct but MC2 can not start the door cycle (moving). */
+#define FIRST_PASSWORD						0xF1 		/* The first password of a new device, MC2 refuses it if a password is already saved. */
 #define OPEN_DOOR							0xF2		/* This used to inform MC2 that the door will be opened by sending a byte from MC1 with a certain value. */
 #define OPEN_DOOR_SCREEN					0xF3		/* To present on screen door is opening. */
 #define OPEN_DOOR_SUCCESS					0xF3		/* To present on screen door is opening. */
@@ -47,14 +59,157 @@
 #define CHANGE_PASSWORD						0xF5		/* This used to inform MC2 that the password will be changed by sending a byte from MC1 with a certain value. */
 #define CORRECT_PASSWORD					0xF6		/* To inform MC1 that the password MC2 received is correct */
 #define WRONG_PASSWORD						0xF7		/* To inform MC1 that the password MC2 received is wrong */
+#define DOOR_STATUS							0xF8		/* Ask MC2 for the door state, MC2 answers with one of the door states below. */
+#define EMERGENCY_OPEN						0xF9		/* Ask MC2 to re-open the door during a running cycle, MC2 answers with one of the door states below. */
+#define SELECT_DOOR							0xFA		/* Select the door of the next commands in MC2, followed by one byte with the door number. */
+#define LOCKED_OUT							0xFB		/* MC2 refused the password because it is locked (for all the doors) after too many wrong passwords. */
+#define LOCKOUT_STATUS						0xFC		/* Ask MC2 for the lockout, MC2 answers with the seconds left in two bytes (high byte first), zero if not locked. */
+#define PASSWORD_STATUS						0xFD		/* Ask MC2 if a password is saved, MC2 answers with PASSWORD_SAVED or NO_PASSWORD. */
+#define PASSWORD_SAVED						0xFE		/* MC2 has a password, start from the main menu. */
+#define NO_PASSWORD							0xFF		/* MC2 has no password yet, ask the user for the first one. */
+
+#define HMI_DOOR_INDEX						0			/* The door of MC2 that this panel controls. */
+
+/* Door states answered by MC2 (same order of DOOR_State in MC2) */
+#define DOOR_IDLE							0
+#define DOOR_OPENING						1
+#define DOOR_HOLDING						2
+#define DOOR_CLOSING						3
+#define DOOR_FAULT							4
+
+/*******************************************************************************
+ *                         	   Types Declaration                               *
+ *******************************************************************************/
+typedef enum{
+	HMI_NEW_PASSWORD,			/* Write the new password for the first time. */
+	HMI_REPEAT_PASSWORD,		/* Write the new password again to confirm it. */
+	HMI_PASSWORD_MISMATCH,		/* Message: the repeated password is wrong. */
+	HMI_REPEAT_PROCESS,			/* Message: repeat the process of saving the password. */
+	HMI_MAIN_MENU,				/* The options available for the user. */
+	HMI_ENTER_PASSWORD,			/* Write the password to open the door or to change the password. */
+	HMI_WAIT_REPLY,				/* Waiting MC2 to check the password. */
+	HMI_DOOR,					/* The door is opening, holding or closing. */
+	HMI_WRONG_PASSWORD,			/* Message: the password is wrong. */
+	HMI_LOCKED,					/* Message: error and the time left while MC2 locks the door. */
+	HMI_DOOR_ERROR,				/* MC2 stopped the door because of a fault, the user closes it again or goes back to the menu. */
+	HMI_STARTING,				/* Waiting MC2 to tell if a password is saved. */
+	HMI_DOOR_BUSY,				/* Message: the door can not be opened now. */
+	HMI_NO_REPLY				/* Message: MC2 did not answer the password. */
+}HMI_State;
+
+/* Actions selected by the option keys of the screens */
+typedef enum{
+	HMI_ACTION_OPEN_DOOR,		/* Write the password to open the door. */
+	HMI_ACTION_CHANGE_PASSWORD,	/* Write the password to change it. */
+	HMI_ACTION_EMERGENCY_OPEN,	/* Re-open the door while it is moving. */
+	HMI_ACTION_CLEAR_FAULT,		/* Close the door in fault again. */
+	HMI_ACTION_MAIN_MENU		/* Leave the door in fault and go back to the main menu. */
+}HMI_Action;
+
 /******************************************************************************
  *							   Global Variables								  *
  ******************************************************************************/
 
-uint16 g_timerCounter = 0;					/* To count number of overflow required to reach required time. */
-uint8 g_timerFlag = 0;						/* To stop program in while loop until the timer finish counting. */
+volatile uint16 g_timerCounter = 0;			/* Incremented by timer0 every 1 ms, the main loop reads it with SYNC_readU16() to count the passed time. */
+
+HMI_State g_hmiState = HMI_STARTING;		/* The current screen of the HMI. */
+uint16 g_hmiTimeout = 0;					/* Time left before the current message ends, zero if the screen is not timed. */
+uint16 g_doorStatusTimer = 0;				/* Time left before asking MC2 again about the door state. */
+uint16 g_lockoutStatusTimer = 0;			/* Time left before asking MC2 again about the lockout. */
+uint8 g_lockoutReplyCounter = 0;			/* Number of bytes received of the lockout answer. */
+uint16 g_lockoutSeconds = 0;				/* Seconds left of the lockout received from MC2. */
+uint16 g_passwordStatusTimer = 0;			/* Time left before asking MC2 again if a password is saved. */
+uint16 g_changePasswordTimer = 0;			/* Time left to send the new password to MC2, zero if no change is running. */
+
+uint8 g_hmiCommand = FIRST_PASSWORD;		/* The command that the user writes the password for (FIRST_PASSWORD, OPEN_DOOR or CHANGE_PASSWORD). */
+uint8 g_doorState = DOOR_IDLE;				/* The last door state presented on the screen. */
+
+uint8 g_passwordFirstSave[PASSWORD_SIZE]; 	/* Array for the first password, also used for the password that the user will provide to open the door. */
+uint8 g_passwordSecondSave[PASSWORD_SIZE];	/* Array for the Repeated password. */
+uint8 g_passwordCounter = 0;				/* Number of password values the user entered on the current screen. */
 
-uint8 g_buzzerAccumulator = 0;				/* To make sure if the user write the password three times wrong the buzzer will be activated for 1 minute. This buzzer reset if the password is correct. */
+#if (LINK_BENCHMARK == TRUE)
+LINK_BenchmarkType g_linkBenchmark;			/* Cycles of a link frame measured at start-up. */
+#endif
+
+#if (RING_BUFFER_BENCHMARK == TRUE)
+RING_BUFFER_BenchmarkType g_ringBufferBenchmark;	/* Cycles of a ring buffer push and pop measured at start-up. */
+RING_BUFFER_DEFINE(g_ringBufferBenchmarkRing, 8);	/* Defined like the queues of the drivers, so the measured code is the same. */
+#endif
+
+/******************************************************************************
+ *								 Screens									  *
+ ******************************************************************************/
+/* Text of each screen: row, column and text */
+static const SCREEN_Item g_newPasswordItems[] PROGMEM 		= {{0, 0, TEXT_SAVE_PASSWORD}};
+static const SCREEN_Item g_repeatPasswordItems[] PROGMEM 	= {{0, 0, TEXT_REPEAT_PASSWORD}};
+static const SCREEN_Item g_mismatchItems[] PROGMEM 			= {{0, 0, TEXT_REPEATED_PASSWORD}, {1, 4, TEXT_IS_WRONG}};
+static const SCREEN_Item g_repeatProcessItems[] PROGMEM 	= {{0, 3, TEXT_REPEAT_THE}, {1, 4, TEXT_PROCESS}};
+static const SCREEN_Item g_mainMenuItems[] PROGMEM 			= {{0, 0, TEXT_OPEN_DOOR_OPTION}, {1, 0, TEXT_CHANGE_PASSWORD_OPTION}};
+static const SCREEN_Item g_enterPasswordItems[] PROGMEM 	= {{0, 0, TEXT_ENTER_PASSWORD}};
+static const SCREEN_Item g_doorOpeningItems[] PROGMEM 		= {{0, 0, TEXT_OPENING_DOOR}};
+static const SCREEN_Item g_doorHoldingItems[] PROGMEM 		= {{0, 0, TEXT_HOLDING_DOOR}};
+static const SCREEN_Item g_doorClosingItems[] PROGMEM 		= {{0, 0, TEXT_CLOSING_DOOR}};
+static const SCREEN_Item g_wrongPasswordItems[] PROGMEM 	= {{0, 0, TEXT_WRONG_PASSWORD}};
+static const SCREEN_Item g_lockedItems[] PROGMEM 			= {{0, 5, TEXT_ERROR}};
+static const SCREEN_Item g_doorErrorItems[] PROGMEM 		= {{0, 3, TEXT_DOOR_FAULT}, {1, 1, TEXT_FAULT_OPTIONS}};
+static const SCREEN_Item g_doorBusyItems[] PROGMEM 			= {{0, 3, TEXT_DOOR_BUSY}};
+static const SCREEN_Item g_noReplyItems[] PROGMEM 			= {{0, 5, TEXT_ERROR}, {1, 4, TEXT_NO_REPLY}};
+
+/* Option keys of each screen: key and action */
+static const SCREEN_MenuItem g_mainMenuOptions[] PROGMEM 	= {{'+', HMI_ACTION_OPEN_DOOR}, {'-', HMI_ACTION_CHANGE_PASSWORD}};
+static const SCREEN_MenuItem g_doorOptions[] PROGMEM 		= {{'+', HMI_ACTION_EMERGENCY_OPEN}};
+static const SCREEN_MenuItem g_doorErrorOptions[] PROGMEM 	= {{'+', HMI_ACTION_CLEAR_FAULT}, {'-', HMI_ACTION_MAIN_MENU}};
+
+/* Screens: text, option keys, input place and time of presenting */
+#define SCREEN_TEXT(items)			items, SCREEN_COUNT_OF(items)
+#define SCREEN_OPTIONS(options)		options, SCREEN_COUNT_OF(options)
+#define SCREEN_NO_OPTIONS			NULL_PTR, 0
+#define SCREEN_NO_INPUT				SCREEN_NO_CURSOR, 0
+
+static const SCREEN_Type g_newPasswordScreen PROGMEM 		= {SCREEN_TEXT(g_newPasswordItems), SCREEN_NO_OPTIONS, 1, 0, 0};
+static const SCREEN_Type g_repeatPasswordScreen PROGMEM 	= {SCREEN_TEXT(g_repeatPasswordItems), SCREEN_NO_OPTIONS, 1, 0, 0};
+static const SCREEN_Type g_mismatchScreen PROGMEM 			= {SCREEN_TEXT(g_mismatchItems), SCREEN_NO_OPTIONS, SCREEN_NO_INPUT, TIMER_MESSAGE};
+static const SCREEN_Type g_repeatProcessScreen PROGMEM 		= {SCREEN_TEXT(g_repeatProcessItems), SCREEN_NO_OPTIONS, SCREEN_NO_INPUT, TIMER_MESSAGE};
+static const SCREEN_Type g_mainMenuScreen PROGMEM 			= {SCREEN_TEXT(g_mainMenuItems), SCREEN_OPTIONS(g_mainMenuOptions), SCREEN_NO_INPUT, 0};
+static const SCREEN_Type g_enterPasswordScreen PROGMEM 		= {SCREEN_TEXT(g_enterPasswordItems), SCREEN_NO_OPTIONS, 1, 0, 0};
+static const SCREEN_Type g_doorOpeningScreen PROGMEM 		= {SCREEN_TEXT(g_doorOpeningItems), SCREEN_OPTIONS(g_doorOptions), SCREEN_NO_INPUT, 0};
+static const SCREEN_Type g_doorHoldingScreen PROGMEM 		= {SCREEN_TEXT(g_doorHoldingItems), SCREEN_OPTIONS(g_doorOptions), SCREEN_NO_INPUT, 0};
+static const SCREEN_Type g_doorClosingScreen PROGMEM 		= {SCREEN_TEXT(g_doorClosingItems), SCREEN_OPTIONS(g_doorOptions), SCREEN_NO_INPUT, 0};
+static const SCREEN_Type g_wrongPasswordScreen PROGMEM 		= {SCREEN_TEXT(g_wrongPasswordItems), SCREEN_NO_OPTIONS, SCREEN_NO_INPUT, TIMER_SHORT_MESSAGE};
+static const SCREEN_Type g_lockedScreen PROGMEM 			= {SCREEN_TEXT(g_lockedItems), SCREEN_NO_OPTIONS, SCREEN_NO_INPUT, 0};
+static const SCREEN_Type g_doorErrorScreen PROGMEM 			= {SCREEN_TEXT(g_doorErrorItems), SCREEN_OPTIONS(g_doorErrorOptions), SCREEN_NO_INPUT, 0};
+static const SCREEN_Type g_doorBusyScreen PROGMEM 			= {SCREEN_TEXT(g_doorBusyItems), SCREEN_NO_OPTIONS, SCREEN_NO_INPUT, TIMER_MESSAGE};
+static const SCREEN_Type g_noReplyScreen PROGMEM 			= {SCREEN_TEXT(g_noReplyItems), SCREEN_NO_OPTIONS, SCREEN_NO_INPUT, TIMER_MESSAGE};
+
+/* Screen of each HMI state (same order of HMI_State), NULL_PTR keeps the screen as it is */
+static const SCREEN_Type * const g_hmiScreens[] PROGMEM =
+{
+	&g_newPasswordScreen,			/* HMI_NEW_PASSWORD */
+	&g_repeatPasswordScreen,		/* HMI_REPEAT_PASSWORD */
+	&g_mismatchScreen,				/* HMI_PASSWORD_MISMATCH */
+	&g_repeatProcessScreen,			/* HMI_REPEAT_PROCESS */
+	&g_mainMenuScreen,				/* HMI_MAIN_MENU */
+	&g_enterPasswordScreen,			/* HMI_ENTER_PASSWORD */
+	NULL_PTR,						/* HMI_WAIT_REPLY */
+	&g_doorOpeningScreen,			/* HMI_DOOR */
+	&g_wrongPasswordScreen,			/* HMI_WRONG_PASSWORD */
+	&g_lockedScreen,				/* HMI_LOCKED */
+	&g_doorErrorScreen,				/* HMI_DOOR_ERROR */
+	NULL_PTR,						/* HMI_STARTING */
+	&g_doorBusyScreen,				/* HMI_DOOR_BUSY */
+	&g_noReplyScreen				/* HMI_NO_REPLY */
+};
+
+/* Screen of each moving door state (DOOR_OPENING, DOOR_HOLDING and DOOR_CLOSING) */
+static const SCREEN_Type * const g_doorScreens[] PROGMEM =
+{
+	&g_doorOpeningScreen,
+	&g_doorHoldingScreen,
+	&g_doorClosingScreen
+};
+
+const SCREEN_Type *g_hmiScreen = &g_newPasswordScreen;		/* The screen presented now, its option keys are accepted. */
 
 
 /*******************************************************************************
@@ -62,9 +217,10 @@ uint8 g_buzzerAccumulator = 0;				/* To make sure if the user write the password
  *******************************************************************************/
 /*
  * Description:
- * Get from the user the values that he entered on the keypad.
+ * Take one key from the user while he writes the password and present (*) for each number.
+ * Return TRUE when all password values are written and the user pressed enter.
  */
-void PASSWORD_getData(uint8 *a_passwordEnterData_ptr);
+uint8 PASSWORD_getData(uint8 key, uint8 *a_passwordEnterData_ptr);
 
 /*
  * Description:
@@ -72,12 +228,6 @@ void PASSWORD_getData(uint8 *a_passwordEnterData_ptr);
  */
 void PASSWORD_sendData(uint8 *a_passwordEnterData_ptr);
 
-/*
- * Description:
- * This function points to two arrays, and save to them the values of the passwords that the user write from the keypad.
- */
-void PASSWORD_saveData(uint8 *a_passwordFirstSave_ptr, uint8 *a_passwordSecondSave_ptr);
-
 /*
  * Description:
  * This function used to check if both first and second passwords are equal or not.
@@ -86,24 +236,59 @@ void PASSWORD_saveData(uint8 *a_passwordFirstSave_ptr, uint8 *a_passwordSecondSa
  */
 uint8 PASSWORD_compareFirstSecondValues(uint8 *a_passwordFirstTime_ptr, uint8 *a_passwordSecondTime_ptr);
 
+/*
+ * Description:
+ * Go to a new state: present its screen and start the screen time if it is a message.
+ */
+void HMI_enterState(HMI_State state);
 
 /*
- * Description;
- * This function use Timer0 in AVR to delay display while opening and closing the door.
+ * Description:
+ * Handle a new key pressed by the user according to the current screen.
  */
-void TIMER0_delayOpenClose(void);
+void HMI_keyEvent(uint8 key);
 
 /*
- * Description;
- * This function use Timer0 in AVR to delay display while holding the door.
+ * Description:
+ * Handle a byte received from MC2 according to the current screen.
+ */
+void HMI_replyEvent(uint8 reply);
+
+/*
+ * Description:
+ * Handle the end of the time of the current message.
+ */
+void HMI_timeoutEvent(void);
+
+/*
+ * Description:
+ * Advance all the HMI times by the passed milliseconds: end messages and ask MC2 about the door.
+ */
+void HMI_tick(uint16 a_passedTime);
+
+/*
+ * Description:
+ * Present on screen the door state received from MC2 while the door is moving.
+ */
+void HMI_doorStatus(uint8 state);
+
+/*
+ * Description:
+ * Collect the lockout answer from MC2 and present the time left, or the main menu when the lockout is finished.
+ */
+void HMI_lockoutStatus(uint8 data);
+
+/*
+ * Description:
+ * Send a door or password command to MC2 for the door of this panel.
  */
-void TIMER0_delayHold(void);
+void HMI_sendDoorCommand(uint8 command);
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while buzzer is activated.
+ * This function is called by Timer0 every 1 ms to count the time for the main loop, scan the keypad and send the LCD queue.
  */
-void TIMER0_delayBuzzer(void);
+void TIMER0_tick(void);
 
 
 /*******************************************************************************
@@ -111,16 +296,10 @@ void TIMER0_delayBuzzer(void);
  *******************************************************************************/
 int main(void)
 {
-	uint8 passwordFirstSave[PASSWORD_SIZE]; 	/* Array for the first password. */
-	uint8 passwordSecondSave[PASSWORD_SIZE];	/* Array for the Repeated password. */
-	uint8 passwordEnterData[PASSWORD_SIZE];		/* Array to save the values of the password that the user will provide to open the door. */
-
-	uint8 optionsStatus = 0;					/* To save the value that came from keypad to select from the options. */
-
-	uint8 passwordCompareResult = FALSE;		/* To hold the the value of TRUE or FALSE to confirm if the password is saved correctly or not. */
-	uint8 receivedPasswordStatus = FALSE;		/* To know if the received password is correct or not. */
-	uint8 passwordStatus = 0;					/* To know from MC2 if the password that send from MC1 is correct or not. */
-	uint8 buzzerStatus	 = 0;					/* To know from MC2 if the buzzer is active or not. */
+	uint16 lastTick = 0;						/* The value of the timer counter in the last loop. */
+	uint16 passedTime = 0;						/* Milliseconds passed since the last loop. */
+	KEYPAD_Event keyEvent;						/* Event taken from the keypad queue. */
+	uint8 reply;								/* Byte received from MC2. */
 
 	/*********************************************
 	 *				Drivers initiation 			 *
@@ -128,216 +307,85 @@ int main(void)
 	/* Enable Global Interrupt I-Bit. */
 	SREG |= (1<<7);
 
-	/* Activate LCD */
+	/* Activate LCD, the HMI writes the screen in the framebuffer and the main loop queues the changes for timer0 to send. */
 	LCD_init();
+	FRAMEBUFFER_init();
 
-	/* Initiate timer0 configuration. */
-	TIMER0_ConfigType TIMER0_config = {TIMER_OVERFLOW_MODE, OC0_DISCONNECTED, F_CPU_1024, DISABLE_CTC_INTERRUPT, ENABLE_OVF_INTERRUPT};
+	/* Clear the keypad state before timer0 starts scanning it. */
+	KEYPAD_init();
+
+	/* Initiate timer0 configuration. The timer keeps running and interrupts every 1 ms. */
+	TIMER0_ConfigType TIMER0_config = {TIMER_CTC_MODE, OC0_DISCONNECTED, F_CPU_64, ENABLE_CTC_INTERRUPT, DISABLE_OVF_INTERRUPT, TIMER_TICK_COMPARE_VALUE};
+	TIMER_setCallBack(TIMER0_tick);
+	TIMER_init(&TIMER0_config);
 
 	/* Activate UART with double speed and eight_bit character size. the baud rate = 9600 bps (using interrupt when receiving a bit). */
-	UART_ConfigType UART_config = {DOUBLE_SPEED, ASYNCHRONOUS, RISING, PARITY_DISABLED, ONE_STOP_BIT, EIGHT_BIT, RX_INTERRUPT_DISABLE, TX_INTERRUPT_DISABLE}; /* UART registers configuration */
+	UART_ConfigType UART_config = {DOUBLE_SPEED, ASYNCHRONOUS, RISING, PARITY_DISABLED, ONE_STOP_BIT, EIGHT_BIT, RX_INTERRUPT_ENABLE, TX_INTERRUPT_ENABLE}; /* UART registers configuration */
 	UART_init(BAUD, &UART_config);
 
-	/*********************************************
-	 *	 Save The Password For The First Time	 *
-	 *********************************************/
-	/* Check each time if the  repeated password is not correct repeat the process. */
-	while(passwordCompareResult != TRUE)
-	{
-		PASSWORD_saveData(passwordFirstSave, passwordSecondSave);										  /* Get password values from the user */
-		passwordCompareResult = PASSWORD_compareFirstSecondValues(passwordFirstSave, passwordSecondSave); /* Check if the password is correct or not */
-		/* Check if the repeated password is correct or not, if correct send it to MC2 to save it in EEPROM. */
-		if(passwordCompareResult == TRUE)
-		{
-			UART_sendByte(FIRST_PASSWORD); 			/* Send Change command Password to the MC2 */
-			PASSWORD_sendData(passwordFirstSave);	/* Send Password */
-		}
+#if (LINK_BENCHMARK == TRUE)
+	/* Measure a link frame with Timer1 (not used by MC1), read the result with the debugger. */
+	LINK_benchmark(&g_linkBenchmark);
+#endif
 
-		/* If the repeated password is not correct the process will be repeated. */
-		else if(passwordCompareResult == FALSE)
-		{
-			/* in case of wrong password, inform the user he repeated the password wrongly. So, the process must be repeated. */
-			LCD_clearScreen();	/* Clear the screen to present new statement on it. */
-			LCD_displayStringRowColumn(0, 0, "Repeated Password");
-			LCD_displayStringRowColumn(1, 4, "is Wrong");
-			_delay_ms(1000);
-			LCD_clearScreen();	/* Clear the screen to present new statement on it. */
-			LCD_displayStringRowColumn(0, 3, "Repeat the");
-			LCD_displayStringRowColumn(1, 4, "Process");
-			_delay_ms(1000);
-		}
-		LCD_clearScreen(); /* Clear the screen to present new statement on it. */
-	}
+#if (RING_BUFFER_BENCHMARK == TRUE)
+	/*
+	 * Measure the queue used by the keypad, the LCD and the UART with Timer1, read the result with the debugger.
+	 * It is a lower bound of the cost in their ISRs, which also save and restore the registers.
+	 */
+	RING_BUFFER_benchmark(&g_ringBufferBenchmarkRing, &g_ringBufferBenchmark);
+#endif
 
-	/* Always after using PASSWORD_compareFirstSecondValues() function make sure to return  this variable to false state to use it another timer for another comparison. */
-	passwordCompareResult = FALSE;
+	/* Start the handshake with MC2, the commands are sent encrypted when the session key is made. */
+	LINK_init(LINK_INITIATOR);
 
-	/* Present on screen the option available  to use by the user. */
-	LCD_clearScreen();	/* Clear the screen to present new statement on it. */
-	LCD_displayStringRowColumn(0, 0, "+: Open Door");
-	LCD_displayStringRowColumn(1, 0, "-: Change Pass");
+	/*********************************************
+	 *	 Ask MC2 If The Password Is Saved		 *
+	 *********************************************/
+	/* The first password is written only if MC2 has none, a reset of MC1 goes back to the main menu. */
+	HMI_enterState(HMI_STARTING);
 
+	/*
+	 * The main loop never waits: keys, bytes from MC2 and time are handled as events when they arrive.
+	 */
 	while(1)
 	{
-		optionsStatus = KEYPAD_getPressedKey();
-
-		/*********************************************
-		 *	When user select option (+) from keypad  *
-		 *********************************************/
-		if(optionsStatus == '+')
+		/* Count the time passed since the last loop. The counter is two bytes, so it is read with the interrupt disabled. */
+		passedTime = SYNC_readU16(&g_timerCounter) - lastTick;
+		if(passedTime != 0)
 		{
-			UART_sendByte(OPEN_DOOR); 					 /* Send command to MC2 to open the door. */
-
-			PASSWORD_getData(passwordEnterData);		 /* Get the password from the user by using the keypad. */
-			PASSWORD_sendData(passwordEnterData);		 /* Send the password to MC2. */
-
-			passwordStatus = UART_recieveByte();		 /* Receive from MC2 the status of the password if it is correct or wrong. */
-
-			/* If the password is correct. */
-			if(passwordStatus == OPEN_DOOR_SUCCESS)
-			{
-				g_buzzerAccumulator = 0;				 /* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
-
-				LCD_clearScreen();						 /* Clear the screen to present new statement on it. */
-				LCD_displayString("Opening the door");	 /* Present opening the door while the motor is rotating clockwise. */
-				TIMER_setCallBack(TIMER0_delayOpenClose);/* This function will call TIMER0_delayOpenClose() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-				TIMER_init(&TIMER0_config);				 /* Activate timer0 to count 15 seconds. */
-				while(g_timerFlag != 1){}				 /* Wait until the timer finish to continue in the code. */
-				g_timerFlag = 0;						 /* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-				LCD_clearScreen();						 /* Clear the screen to present new statement on it. */
-				LCD_displayString("Holding the door");	 /* Present holding the door while the motor is in holding condition.*/
-				TIMER_setCallBack(TIMER0_delayHold);	 /* This function will call TIMER0_delayHold() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-				TIMER_init(&TIMER0_config);				 /* Activate timer0 to count 3 seconds. */
-				while(g_timerFlag != 1){}				 /* Wait until the timer finish to continue in the code. */
-				g_timerFlag = 0;						 /* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-				LCD_clearScreen();						 /* Clear the screen to present new statement on it. */
-				LCD_displayString("Closing the door");	 /* Present closing the door while the motor is rotating Anti-clockwise.*/
-				TIMER_setCallBack(TIMER0_delayOpenClose);/* This function will call TIMER0_delayOpenClose() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-				TIMER_init(&TIMER0_config);				 /* Activate timer0 to count 15 seconds. */
-				while(g_timerFlag != 1){}				 /* Wait until the timer finish to continue in the code. */
-				g_timerFlag = 0;						 /* Always after the timer flag become become on, the developer must make it zero again for another use. */
-			}
-
-			/* If the password is not correct. */
-			else if(passwordStatus ==  OPEN_DOOR_FAILED)
-			{
-				g_buzzerAccumulator++;					 /* Increment the buzzer counter every time the user write wrong password */
-
-				LCD_clearScreen();						 /* Clear the screen to present new statement on it. */
-
-				/* Check on the buzzer g_buzzerAccumulator. if not reach the maximum tries, a message will appear for a second to inform the user that he wrought a wrong password*/
-				if(g_buzzerAccumulator != MAX_NUMBER_OF_ERRORS)
-				{
-					LCD_displayString("Wrong Password"); /* Inform the user that he wrought a wrong password. */
-					_delay_ms(500);
-				}
-
-				/* If the buzzer counter reach the maximum number of tries, the buzzer will be activated for one minute. */
-				if(g_buzzerAccumulator == MAX_NUMBER_OF_ERRORS)
-				{
-					LCD_clearScreen();					 /* Clear the screen to present new statement on it. */
-					LCD_displayStringRowColumn(0, 5, "ERROR!!"); /* Inform the user that an error has occurred due to he wrought the password many times wrong. */
-
-					TIMER_setCallBack(TIMER0_delayBuzzer);/* This function will call TIMER0_delayBuzzer() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-					TIMER_init(&TIMER0_config);			 /* Activate timer0 to count 60 seconds. */
-					while(g_timerFlag != 1){}			 /* Wait until the timer finish to continue in the code. */
-					g_timerFlag = 0;					 /* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-					g_buzzerAccumulator = 0;			 /* Make the buzzer accumulator zero again to repeat the process of waiting from the user to write the password wrong three times. */
-				}
-			}
-
-			/* Present on screen the option available  to use by the user. */
-			LCD_clearScreen();							 /* Clear the screen to present new statement on it. */
-			LCD_displayStringRowColumn(0, 0, "+: Open Door");
-			LCD_displayStringRowColumn(1, 0, "-: Change Pass");
+			lastTick += passedTime;
+			HMI_tick(passedTime);
+			LINK_tick(passedTime);
 		}
 
-		/*********************************************
-		 *	When user select option (-) from keypad  *
-		 *********************************************/
-		else if(optionsStatus == '-')
+		/* Handle the keys debounced by the timer. Only presses are used, so holding a key does not repeat a password digit. */
+		while(KEYPAD_getEvent(&keyEvent))
 		{
-			UART_sendByte(CHANGE_PASSWORD);				 /* Send command to MC2 to change the password. */
-
-			PASSWORD_getData(passwordEnterData);		 /* Get the password from the user by using the keypad. */
-			PASSWORD_sendData(passwordEnterData);		 /* Send the password to MC2. */
-
-			receivedPasswordStatus = UART_recieveByte(); /* Receive from MC2 the status of the password if it is correct or wrong. */
-
-			/* If the password is correct. */
-			if(receivedPasswordStatus == CORRECT_PASSWORD)
+			if(keyEvent.type == KEYPAD_PRESS)
 			{
-				g_buzzerAccumulator = 0;				 /* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
-
-				/* Check each time if the  repeated password is not correct repeat the process. */
-				while(passwordCompareResult != TRUE)
-				{
-					PASSWORD_saveData(passwordFirstSave, passwordSecondSave); 										  /* Get password values from the user. */
-					passwordCompareResult = PASSWORD_compareFirstSecondValues(passwordFirstSave, passwordSecondSave); /* Check if the password is correct or not. */
-
-					/* Check each time if the  repeated password is not correct repeat the process. */
-					if(passwordCompareResult == TRUE)
-					{
-						PASSWORD_sendData(passwordFirstSave);/* Send Password */
-					}
-
-					/* If the repeated password is not correct the process will be repeated. */
-					if(passwordCompareResult == FALSE)
-					{
-						/* in case of wrong password, inform the user he repeated the password wrongly and the process must be repeated. */
-						LCD_clearScreen();	/* Clear the screen to present new statement on it */
-						LCD_displayStringRowColumn(0, 0, "Repeated Password");
-						LCD_displayStringRowColumn(1, 4, "is Wrong");
-						_delay_ms(1000);
-						LCD_clearScreen();				 /* Clear the screen to present new statement on it. */
-						LCD_displayStringRowColumn(0, 3, "Repeat the");
-						LCD_displayStringRowColumn(1, 4, "Process");
-						_delay_ms(1000);
-					}
-					LCD_clearScreen();					 /* Clear the screen to present new statement on it. */
-				}
-
-				/* Always after using PASSWORD_compareFirstSecondValues() function make sure to return  this variable to false state to use it another timer for another comparison. */
-				passwordCompareResult = FALSE;
+				HMI_keyEvent(keyEvent.key);
 			}
+		}
 
-			/* If the password is not correct. */
-			else if(receivedPasswordStatus == WRONG_PASSWORD)
-			{
-				g_buzzerAccumulator++;					 /* Increment the buzzer counter every time the user write wrong password */
-
-				LCD_clearScreen();						 /* Clear the screen to present new statement on it. */
-
-				/* Check on the buzzer g_buzzerAccumulator. if not reach the maximum tries, a message will appear for a second to inform the user that he wrought a wrong password*/
-				if(g_buzzerAccumulator != MAX_NUMBER_OF_ERRORS)
-				{
-					LCD_displayString("Wrong Password"); /* Inform the user that he wrought a wrong password. */
-					_delay_ms(500);
-				}
-
-				/* If the buzzer counter reach the maximum number of tries, the buzzer will be activated for one minute. */
-				if(g_buzzerAccumulator == MAX_NUMBER_OF_ERRORS)
-				{
-					LCD_clearScreen();					 /* Clear the screen to present new statement on it. */
-					LCD_displayStringRowColumn(0, 5, "ERROR!!"); /* Inform the user that an error has occurred due to he wrought the password many times wrong. */
+		/* Handle the bytes received from MC2, the link gives them after the frame is checked. */
+		if(LINK_receiveByte(&reply))
+		{
+			HMI_replyEvent(reply);
+		}
 
-					TIMER_setCallBack(TIMER0_delayBuzzer); /* This function will call TIMER0_delayBuzzer() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-					TIMER_init(&TIMER0_config);			 /* Activate timer0 to count 60 seconds. */
-					while(g_timerFlag != 1){}			 /* Wait until the timer finish to continue in the code. */
-					g_timerFlag = 0;					 /* Always after the timer flag become become on, the developer must make it zero again for another use. */
+		/* A new handshake means MC2 may have been reset and dropped the password change, give it up too. */
+		if(LINK_takeNewSession() && (g_changePasswordTimer != 0))
+		{
+			g_changePasswordTimer = 0;
+			HMI_enterState(HMI_MAIN_MENU);
+		}
 
-					g_buzzerAccumulator = 0;			 /* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
-				}
-			}
+		/* Send the bytes of the events of this pass to MC2 as one frame. */
+		LINK_flush();
 
-			/* Present on screen the option available  to use by the user. */
-			LCD_clearScreen();							 /* Clear the screen to present new statement on it. */
-			LCD_displayStringRowColumn(0, 0, "+: Open Door");
-			LCD_displayStringRowColumn(1, 0, "-: Change Pass");
-		}
+		/* Present on the LCD what the events changed on the screen. */
+		FRAMEBUFFER_flush();
 	}
 }
 
@@ -350,35 +398,32 @@ int main(void)
 
 /*
  * Description:
- * Get from the user the values that he entered on the keypad and send it to MC2 to check if the password is correct.
+ * Take one key from the user while he writes the password and present (*) for each number.
+ * Return TRUE when all password values are written and the user pressed enter.
  */
-void PASSWORD_getData(uint8 *a_passwordEnterData_ptr)
+uint8 PASSWORD_getData(uint8 key, uint8 *a_passwordEnterData_ptr)
 {
-	uint8 passwordCounter = 0; 				/* To count the loop to get the values of the password. */
-
-	LCD_clearScreen();	/* Clear the screen to present new statement on it. */
-	LCD_displayStringRowColumn(0, 0, "Enter Password:");	/* Display on LCD (Enter Password:). */
-	LCD_moveCursor(1, 0);									/* Move the cursor to the second line. */
-
-	/* This loop to get password values from the user */
-	while((passwordCounter < PASSWORD_SIZE))
+	/* All password values are written, waiting from user to press enter. */
+	if(g_passwordCounter == PASSWORD_SIZE)
 	{
-		a_passwordEnterData_ptr[passwordCounter] = KEYPAD_getPressedKey(); /* Get each keypad input and save its value in a variable from the array. */
-
-		/*	Check if the input not a number from the keypad, repeat the loop until it get a number.	*/
-		if((a_passwordEnterData_ptr[passwordCounter]<0) || (a_passwordEnterData_ptr[passwordCounter]>9))
+		if((key == ENTER) || (key == ENTER_4X3))
 		{
-			continue;
+			return TRUE;
 		}
+		return FALSE;
+	}
 
-		LCD_displayCharacter('*'); 			/* For each input form the keypad, the LCD will display (*). */
-		_delay_ms(500); 					/* delay for 0.5 second between each input from the keypad. */
-
-		passwordCounter++; 					/* Increment to the next variable in the array. */
+	/*	Check if the input not a number from the keypad, ignore it until the user press a number. */
+	if(key > 9)
+	{
+		return FALSE;
 	}
 
-	/* Waiting from user to press enter. */
-	while(KEYPAD_getPressedKey() != ENTER){};
+	a_passwordEnterData_ptr[g_passwordCounter] = key;	/* Save the keypad input in a variable from the array. */
+	FRAMEBUFFER_displayCharacter('*'); 						/* For each input form the keypad, the LCD will display (*). */
+	g_passwordCounter++; 								/* Increment to the next variable in the array. */
+
+	return FALSE;
 }
 
 /*
@@ -392,147 +437,447 @@ void PASSWORD_sendData(uint8 *a_passwordEnterData_ptr)
 	/* Loop on each character from the password and send it to MC2 character by character. */
 	for(passwordCounter = 0; passwordCounter < PASSWORD_SIZE; passwordCounter++)
 	{
-		UART_sendByte(a_passwordEnterData_ptr[passwordCounter]); /* Send all 4 password Numbers to MC2. */
+		LINK_sendByte(a_passwordEnterData_ptr[passwordCounter]); /* Send all 4 password Numbers to MC2. */
 	}
 }
 
 /*
  * Description:
- * This function points to two arrays, and save to them the values of the passwords that the user write from the keypad.
+ * This function used to check if both first and second passwords are equal.
+ * If the password is set correctly, start to send the password by UART to the MC2.
+ * Else repeat the process.
  */
-void PASSWORD_saveData(uint8 *a_passwordFirstSave_ptr, uint8 *a_passwordSecondSave_ptr)
+uint8 PASSWORD_compareFirstSecondValues(uint8 *a_passwordFirstTime_ptr, uint8 *a_passwordSecondTime_ptr)
 {
-	uint8 passwordFirstSaveCounter = 0; 	/* To count for the first array to save the first input password. */
-	uint8 passwordSecondSaveCounter = 0;	/* To count for the second array to save the second input password. */
+	uint8 counter 	= 0; 			/* to count values in both arrays. */
+	uint8 reference = 0;			/* To take a decision according to the all values are correctly equal or not. */
 
-	LCD_clearScreen();										/* Clear the screen to present new statement on it. */
-	LCD_displayStringRowColumn(0, 0, "Save Password:"); 	/* Display on LCD (Save Password:). */
-	LCD_moveCursor(1, 0);									/* Move the cursor to the second line. */
+	/* Check if both first and second passwords are equal.  */
+	while(counter < PASSWORD_SIZE)
+	{
+		if(a_passwordFirstTime_ptr[counter] == a_passwordSecondTime_ptr[counter])
+		{
+			reference++; 			/* This reference will be indicator to check if 4 characters are equal. */
+		}
+		counter++;
+	}
 
-	/* This loop to save first input password. */
-	while((passwordFirstSaveCounter < PASSWORD_SIZE))
+	/* If the password is set correctly, start to send the password by UART to the MC2. */
+	if(reference == PASSWORD_SIZE)
 	{
-		a_passwordFirstSave_ptr[passwordFirstSaveCounter] = KEYPAD_getPressedKey();		/* Get each keypad input and save its value in a variable from the array. */
+		return TRUE;
+	}
 
-		/*	Check if the input not a number from the keypad, repeat the loop until it get a number. */
-		if((a_passwordFirstSave_ptr[passwordFirstSaveCounter]<0) || (a_passwordFirstSave_ptr[passwordFirstSaveCounter]>9))
+	/* Return false to repeat the process. */
+	else
+	{
+		return FALSE;
+	}
+
+}
+
+/*
+ * Description:
+ * Go to a new state: present its screen and start the screen time if it is a message.
+ */
+void HMI_enterState(HMI_State state)
+{
+	const SCREEN_Type *screen = (const SCREEN_Type *)pgm_read_ptr(&g_hmiScreens[state]);
+
+	g_hmiState = state;
+	g_hmiTimeout = 0;
+
+	/* Waiting MC2 keeps the screen as it is, a password is answered in TIMER_WAIT_REPLY or never. */
+	if(screen == NULL_PTR)
+	{
+		if(state == HMI_WAIT_REPLY)
 		{
-			continue;
+			g_hmiTimeout = TIMER_WAIT_REPLY;
 		}
+		return;
+	}
 
-		LCD_displayCharacter('*'); 		/* For each input form the keypad, the LCD will display (*). */
-		_delay_ms(500); 				/* delay for 0.5 second between each input from the keypad. */
+	/* Present the screen, only the cells that differ from the last screen will be sent. */
+	g_hmiScreen = screen;
+	SCREEN_show(screen);
+	g_hmiTimeout = SCREEN_getTimeout(screen);
 
-		passwordFirstSaveCounter++; 	/* Increment to the next variable in the array. */
+	switch(state)
+	{
+	case HMI_NEW_PASSWORD:
+	case HMI_REPEAT_PASSWORD:
+	case HMI_ENTER_PASSWORD:
+		g_passwordCounter = 0;						/* Start writing the password from its first value. */
+		break;
+
+	case HMI_DOOR:
+		g_doorState = DOOR_OPENING;
+		g_doorStatusTimer = TIMER_DOOR_STATUS;
+		break;
+
+	case HMI_LOCKED:
+		g_lockoutStatusTimer = 0;					/* Ask MC2 about the time left on the next tick. */
+		break;
+
+	default:
+		break;
 	}
+}
 
-	/* Waiting from user to press enter */
-	while(KEYPAD_getPressedKey() != ENTER){};
-
-	/* clear the screen and present on screen (Repeat Password). */
-	LCD_clearScreen();					/* Clear the screen to present new statement on it. */
-	LCD_displayStringRowColumn(0, 0, "Repeat Password:");
-	LCD_moveCursor(1, 0);
+/*
+ * Description:
+ * Handle a new key pressed by the user according to the current screen.
+ */
+void HMI_keyEvent(uint8 key)
+{
+	/* Option keys of the current screen. */
+	switch(SCREEN_getAction(g_hmiScreen, key))
+	{
+	case HMI_ACTION_OPEN_DOOR:
+		g_hmiCommand = OPEN_DOOR;
+		HMI_enterState(HMI_ENTER_PASSWORD);
+		return;
+
+	case HMI_ACTION_CHANGE_PASSWORD:
+		g_hmiCommand = CHANGE_PASSWORD;
+		HMI_enterState(HMI_ENTER_PASSWORD);
+		return;
+
+	case HMI_ACTION_EMERGENCY_OPEN:
+		/* Re-open the door while it is moving, MC2 answers with the new door state. */
+		HMI_sendDoorCommand(EMERGENCY_OPEN);
+		return;
+
+	case HMI_ACTION_CLEAR_FAULT:
+		/* MC2 closes the door again, present the closing door and follow it until it is closed or in fault again. */
+		HMI_enterState(HMI_DOOR);
+		HMI_doorStatus(DOOR_CLOSING);
+		HMI_sendDoorCommand(CLEAR_FAULT);
+		return;
+
+	case HMI_ACTION_MAIN_MENU:
+		HMI_enterState(HMI_MAIN_MENU);
+		return;
+
+	default:
+		break;
+	}
 
-	/* This loop to save second input password */
-	while((passwordSecondSaveCounter < PASSWORD_SIZE))
+	/* Password values written on the current screen. */
+	switch(g_hmiState)
 	{
-		a_passwordSecondSave_ptr[passwordSecondSaveCounter] = KEYPAD_getPressedKey();	/* Get each keypad input and save its value in a variable from the array. */
+	case HMI_NEW_PASSWORD:
+		if(PASSWORD_getData(key, g_passwordFirstSave) == TRUE)
+		{
+			HMI_enterState(HMI_REPEAT_PASSWORD);
+		}
+		break;
+
+	case HMI_REPEAT_PASSWORD:
+		if(PASSWORD_getData(key, g_passwordSecondSave) == TRUE)
+		{
+			/* Check if the repeated password is correct or not, if correct send it to MC2 to save it in EEPROM. */
+			if(PASSWORD_compareFirstSecondValues(g_passwordFirstSave, g_passwordSecondSave) == TRUE)
+			{
+				/* While changing the password MC2 is already waiting for the new password after CORRECT_PASSWORD. */
+				if(g_hmiCommand != CHANGE_PASSWORD)
+				{
+					LINK_sendByte(FIRST_PASSWORD); 	/* Send first password command to the MC2 */
+				}
+				PASSWORD_sendData(g_passwordFirstSave);	/* Send Password */
+				g_changePasswordTimer = 0;
+				HMI_enterState(HMI_MAIN_MENU);
+			}
+
+			/* If the repeated password is not correct the process will be repeated. */
+			else
+			{
+				HMI_enterState(HMI_PASSWORD_MISMATCH);
+			}
+		}
+		break;
+
+	case HMI_ENTER_PASSWORD:
+		if(PASSWORD_getData(key, g_passwordFirstSave) == TRUE)
+		{
+			HMI_sendDoorCommand(g_hmiCommand);		/* Send command to MC2 to open the door or to change the password. */
+			PASSWORD_sendData(g_passwordFirstSave);	/* Send the password to MC2. */
+			HMI_enterState(HMI_WAIT_REPLY);
+		}
+		break;
 
-		/*	Check if the input not a number from the keypad, repeat the loop until it get a number.	*/
-		if((a_passwordSecondSave_ptr[passwordSecondSaveCounter]<0) || (a_passwordSecondSave_ptr[passwordSecondSaveCounter]>9))
+	default:
+		break;
+	}
+}
+
+/*
+ * Description:
+ * Handle a byte received from MC2 according to the current screen.
+ */
+void HMI_replyEvent(uint8 reply)
+{
+	if(g_hmiState == HMI_STARTING)
+	{
+		if(reply == PASSWORD_SAVED)
 		{
-			continue;
+			HMI_enterState(HMI_MAIN_MENU);
 		}
+		else if(reply == NO_PASSWORD)
+		{
+			g_hmiCommand = FIRST_PASSWORD;
+			HMI_enterState(HMI_NEW_PASSWORD);
+		}
+		return;
+	}
+
+	if(g_hmiState == HMI_DOOR)
+	{
+		HMI_doorStatus(reply);
+		return;
+	}
 
-		LCD_displayCharacter('*');   		/* For each input form the keypad, the LCD will display (*). */
-		_delay_ms(500); 			 		/* delay for 0.1 second between each input from the keypad. */
+	if(g_hmiState == HMI_LOCKED)
+	{
+		HMI_lockoutStatus(reply);
+		return;
+	}
 
-		passwordSecondSaveCounter++; 		/* Increment to the next variable in the array. */
+	if(g_hmiState != HMI_WAIT_REPLY)
+	{
+		return;
 	}
 
-	/* Waiting from user to press enter. */
-	while(KEYPAD_getPressedKey() != ENTER){};
+	switch(reply)
+	{
+	/* If the password is correct. */
+	case OPEN_DOOR_SUCCESS:
+		HMI_enterState(HMI_DOOR);
+		break;
+
+	/* The password is correct but the door did not start, present it and go back to the main menu. */
+	case DOOR_BUSY:
+		HMI_enterState(HMI_DOOR_BUSY);
+		break;
+
+	/* The password is correct but the door is in fault, offer to close it again. */
+	case DOOR_IN_FAULT:
+		HMI_enterState(HMI_DOOR_ERROR);
+		break;
+
+	case CORRECT_PASSWORD:
+		g_changePasswordTimer = TIMER_CHANGE_PASSWORD;
+		HMI_enterState(HMI_NEW_PASSWORD);		 /* Start saving the new password, g_hmiCommand is still CHANGE_PASSWORD. */
+		break;
+
+	/* If the password is not correct. */
+	case OPEN_DOOR_FAILED:
+	case WRONG_PASSWORD:
+		HMI_enterState(HMI_WRONG_PASSWORD);
+		break;
+
+	/* MC2 counts the wrong passwords and locks the door, present the time left until MC2 accepts passwords again. */
+	case LOCKED_OUT:
+		HMI_enterState(HMI_LOCKED);
+		break;
+
+	default:
+		break;
+	}
 }
 
 /*
  * Description:
- * This function used to check if both first and second passwords are equal.
- * If the password is set correctly, start to send the password by UART to the MC2.
- * Else repeat the process.
+ * Handle the end of the time of the current message.
  */
-uint8 PASSWORD_compareFirstSecondValues(uint8 *a_passwordFirstTime_ptr, uint8 *a_passwordSecondTime_ptr)
+void HMI_timeoutEvent(void)
 {
-	uint8 counter 	= 0; 			/* to count values in both arrays. */
-	uint8 reference = 0;			/* To take a decision according to the all values are correctly equal or not. */
+	switch(g_hmiState)
+	{
+	case HMI_PASSWORD_MISMATCH:
+		HMI_enterState(HMI_REPEAT_PROCESS);
+		break;
+
+	case HMI_REPEAT_PROCESS:
+		HMI_enterState(HMI_NEW_PASSWORD);
+		break;
+
+	/*
+	 * MC2 did not answer the password: present the error, then the main menu. The password is not sent again,
+	 * MC2 may have checked it already and a second wrong try would be counted twice.
+	 */
+	case HMI_WAIT_REPLY:
+		HMI_enterState(HMI_NO_REPLY);
+		break;
+
+	default:
+		HMI_enterState(HMI_MAIN_MENU);
+		break;
+	}
+}
 
-	/* Check if both first and second passwords are equal.  */
-	while(counter < PASSWORD_SIZE)
+/*
+ * Description:
+ * Advance all the HMI times by the passed milliseconds: end messages and ask MC2 about the door.
+ */
+void HMI_tick(uint16 a_passedTime)
+{
+	/* End the current message when its time is finished. */
+	if(g_hmiTimeout != 0)
 	{
-		if(a_passwordFirstTime_ptr[counter] == a_passwordSecondTime_ptr[counter])
+		if(g_hmiTimeout > a_passedTime)
 		{
-			reference++; 			/* This reference will be indicator to check if 4 characters are equal. */
+			g_hmiTimeout -= a_passedTime;
+		}
+		else
+		{
+			g_hmiTimeout = 0;
+			HMI_timeoutEvent();
 		}
-		counter++;
 	}
 
-	/* If the password is set correctly, start to send the password by UART to the MC2. */
-	if(reference == PASSWORD_SIZE)
+	/* MC2 waits for the new password for a limited time only, give up the change before MC2 does. */
+	if(g_changePasswordTimer != 0)
 	{
-		return TRUE;
+		if(g_changePasswordTimer > a_passedTime)
+		{
+			g_changePasswordTimer -= a_passedTime;
+		}
+		else
+		{
+			g_changePasswordTimer = 0;
+			HMI_enterState(HMI_MAIN_MENU);
+		}
 	}
 
-	/* Return false to repeat the process. */
-	else
+	/* Ask MC2 if a password is saved as soon as the link is ready, again until MC2 answers. */
+	if((g_hmiState == HMI_STARTING) && LINK_isReady())
 	{
-		return FALSE;
+		if(g_passwordStatusTimer > a_passedTime)
+		{
+			g_passwordStatusTimer -= a_passedTime;
+		}
+		else
+		{
+			g_passwordStatusTimer = TIMER_PASSWORD_STATUS;
+			LINK_sendByte(PASSWORD_STATUS);
+		}
 	}
 
+	/* Ask MC2 about the time left of the lockout, MC2 counts it so both sides agree even after a reset. */
+	if(g_hmiState == HMI_LOCKED)
+	{
+		if(g_lockoutStatusTimer > a_passedTime)
+		{
+			g_lockoutStatusTimer -= a_passedTime;
+		}
+		else
+		{
+			g_lockoutStatusTimer = TIMER_LOCKOUT_STATUS;
+			g_lockoutReplyCounter = 0;
+			HMI_sendDoorCommand(LOCKOUT_STATUS);
+		}
+	}
+
+	/* Ask MC2 about the door state while the door is moving. */
+	if(g_hmiState == HMI_DOOR)
+	{
+		if(g_doorStatusTimer > a_passedTime)
+		{
+			g_doorStatusTimer -= a_passedTime;
+		}
+		else
+		{
+			g_doorStatusTimer = TIMER_DOOR_STATUS;
+			HMI_sendDoorCommand(DOOR_STATUS);
+		}
+	}
 }
 
 /*
- * Description;
- * This function use Timer0 in AVR to delay display while opening and closing the door.
+ * Description:
+ * Present on screen the door state received from MC2 while the door is moving.
  */
-void TIMER0_delayOpenClose(void)
+void HMI_doorStatus(uint8 state)
 {
-	g_timerCounter++;								/* For each interrupt this counter will increment by one. */
-
-	/* Check if the timer counter reach the required limit. */
-    if(g_timerCounter == TIMER_OPEN_CLOSE_DOOR)
-    {
-    	TIMER_deinit();								/* After the number of required interrupt is ended, the timer will stop by this function. */
-    	g_timerFlag = 1;							/* Open this flag will make the delay stop, must be closed again by the developer if he wants to use the delay function again. */
-        g_timerCounter = 0;							/* make timer counter zero again to be able to use it again and count up form zero. */
-    }
+	/* Nothing changed on the door. */
+	if(state == g_doorState)
+	{
+		return;
+	}
+	g_doorState = state;
+
+	switch(state)
+	{
+	case DOOR_IDLE:
+		HMI_enterState(HMI_MAIN_MENU);			 /* The door is closed, present the options again. */
+		break;
+
+	case DOOR_OPENING:
+	case DOOR_HOLDING:
+	case DOOR_CLOSING:
+		/* Present opening, holding or closing the door, the screen keeps accepting the emergency re-open key. */
+		g_hmiScreen = (const SCREEN_Type *)pgm_read_ptr(&g_doorScreens[state - DOOR_OPENING]);
+		SCREEN_show(g_hmiScreen);
+		break;
+
+	case DOOR_FAULT:
+		HMI_enterState(HMI_DOOR_ERROR);
+		break;
+
+	default:
+		break;
+	}
 }
 
 /*
- * Description;
- * This function use Timer0 in AVR to delay display while holding the door.
+ * Description:
+ * Collect the lockout answer from MC2 and present the time left, or the main menu when the lockout is finished.
+ */
+void HMI_lockoutStatus(uint8 data)
+{
+	/* The seconds are two bytes, high byte first. */
+	if(g_lockoutReplyCounter == 0)
+	{
+		g_lockoutSeconds = (uint16)data << 8;
+		g_lockoutReplyCounter = 1;
+		return;
+	}
+	g_lockoutSeconds |= data;
+	g_lockoutReplyCounter = 0;
+
+	if(g_lockoutSeconds == 0)
+	{
+		HMI_enterState(HMI_MAIN_MENU);
+		return;
+	}
+
+	/* Present the time left as minutes:seconds, the framebuffer sends the digits only when they change. */
+	FRAMEBUFFER_moveCursor(1, 5);
+	FORMAT_unsigned(FRAMEBUFFER_displayCharacter, g_lockoutSeconds / 60, 2, FORMAT_PAD_ZERO);
+	FRAMEBUFFER_displayCharacter(':');
+	FORMAT_unsigned(FRAMEBUFFER_displayCharacter, g_lockoutSeconds % 60, 2, FORMAT_PAD_ZERO);
+}
+
+/*
+ * Description:
+ * Send a door or password command to MC2 for the door of this panel.
+ * MC2 can serve more than one door, so the door is selected before each command.
  */
-void TIMER0_delayHold(void)
+void HMI_sendDoorCommand(uint8 command)
 {
-	g_timerCounter++;								/* For each interrupt this counter will increment by one. */
-    if(g_timerCounter == TIMER_HOLD_DOOR)
-    {
-        TIMER_deinit();								/* After the number of required interrupt is ended, the timer will stop by this function. */
-    	g_timerFlag = 1;							/* Open this flag will make the delay stop, must be closed again by the developer if he wants to use the delay function again. */
-        g_timerCounter = 0;							/* make timer counter zero again to be able to use it again and count up form zero. */
-    }
+	LINK_sendByte(SELECT_DOOR);
+	LINK_sendByte(HMI_DOOR_INDEX);
+	LINK_sendByte(command);
 }
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while buzzer is activated.
+ * This function is called by Timer0 every 1 ms to count the time for the main loop, scan the keypad and send the LCD queue.
  */
-void TIMER0_delayBuzzer(void)
+void TIMER0_tick(void)
 {
-	g_timerCounter++;								/* For each interrupt this counter will increment by one. */
-    if(g_timerCounter == TIMER_BUZZER)
-    {
-        TIMER_deinit();								/* After the number of required interrupt is ended, the timer will stop by this function. */
-    	g_timerFlag = 1;							/* Open this flag will make the delay stop, must be closed again by the developer if he wants to use the delay function again. */
-        g_timerCounter = 0;							/* make timer counter zero again to be able to use it again and count up form zero. */
-    }
+	g_timerCounter++;
+	KEYPAD_scanTick();
+	LCD_queueTick();
 }
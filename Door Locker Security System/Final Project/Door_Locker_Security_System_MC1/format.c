@@ -0,0 +1,160 @@
+/****************************************************************************************
+ *
+ * Module: Format
+ *
+ * File Name: format.c
+ *
+ * Discretion: Source file for the number formatting
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                      		Include Header	                               *
+ *******************************************************************************/
+#include "format.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* Number of decimal digits of the biggest uint16 (65535) */
+#define FORMAT_DECIMAL_DIGITS			5
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/*
+ * Weight of each decimal digit from the most significant one.
+ * Each digit is found by subtracting its weight, AVR has no divide instruction
+ * and the subtractions are cheaper than the 16-bit division routine.
+ */
+static const uint16 g_formatPowersOfTen[FORMAT_DECIMAL_DIGITS] PROGMEM = {10000, 1000, 100, 10, 1};
+
+/*******************************************************************************
+ *                      	Function Prototypes                                *
+ *******************************************************************************/
+static void FORMAT_decimal(FORMAT_Sink a_sink, uint16 magnitude, uint8 negative, uint8 fraction, uint8 width, uint8 pad);
+
+/*******************************************************************************
+ *                      	Function Definitions                               *
+ *******************************************************************************/
+/*
+ * Description:
+ * Send the sign, the padding and the digits of a decimal number from the most significant digit.
+ * If fraction is not 0, a '.' is sent before the last fraction digits.
+ */
+static void FORMAT_decimal(FORMAT_Sink a_sink, uint16 magnitude, uint8 negative, uint8 fraction, uint8 width, uint8 pad)
+{
+	uint8 first = 0;									/* Index of the first sent digit in g_formatPowersOfTen. */
+	uint8 length;
+	uint8 index;
+	uint8 digit;
+	uint16 weight;
+
+	if(fraction > FORMAT_MAX_FRACTION)
+	{
+		fraction = FORMAT_MAX_FRACTION;
+	}
+
+	/* Skip the leading zeros, but keep one integer digit and all the fraction digits. */
+	while((first < (FORMAT_DECIMAL_DIGITS - 1 - fraction)) && (magnitude < pgm_read_word(&g_formatPowersOfTen[first])))
+	{
+		first++;
+	}
+
+	length = (FORMAT_DECIMAL_DIGITS - first) + negative + ((fraction != 0) ? 1 : 0);
+
+	/* Spaces go before the sign and zeros after it. */
+	if(pad != FORMAT_PAD_ZERO)
+	{
+		for(; length < width; length++)
+		{
+			a_sink(pad);
+		}
+	}
+	if(negative)
+	{
+		a_sink('-');
+	}
+	for(; length < width; length++)
+	{
+		a_sink(FORMAT_PAD_ZERO);
+	}
+
+	for(index = first; index < FORMAT_DECIMAL_DIGITS; index++)
+	{
+		if((fraction != 0) && (index == (FORMAT_DECIMAL_DIGITS - fraction)))
+		{
+			a_sink('.');
+		}
+
+		weight = pgm_read_word(&g_formatPowersOfTen[index]);
+		digit = '0';
+		while(magnitude >= weight)
+		{
+			magnitude -= weight;
+			digit++;
+		}
+		a_sink(digit);
+	}
+}
+
+/*
+ * Description:
+ * Send an unsigned decimal number. If it is shorter than the width, it is padded on the left
+ * with FORMAT_PAD_SPACE or FORMAT_PAD_ZERO. Width 0 sends only the digits.
+ */
+void FORMAT_unsigned(FORMAT_Sink a_sink, uint16 value, uint8 width, uint8 pad)
+{
+	FORMAT_decimal(a_sink, value, FALSE, 0, width, pad);
+}
+
+/*
+ * Description:
+ * Send a signed decimal number. The '-' is put before zero padding and after space padding.
+ */
+void FORMAT_signed(FORMAT_Sink a_sink, sint16 value, uint8 width, uint8 pad)
+{
+	FORMAT_fixed(a_sink, value, 0, width, pad);
+}
+
+/*
+ * Description:
+ * Send a fixed-point number: the value is the real number multiplied by 10^fraction.
+ * e.g. value 1234 with fraction 2 is sent as "12.34" and -5 with fraction 1 as "-0.5".
+ */
+void FORMAT_fixed(FORMAT_Sink a_sink, sint16 value, uint8 fraction, uint8 width, uint8 pad)
+{
+	/* The magnitude is taken in unsigned, so -32768 is converted correctly. */
+	if(value < 0)
+	{
+		FORMAT_decimal(a_sink, (uint16)(0u - (uint16)value), TRUE, fraction, width, pad);
+	}
+	else
+	{
+		FORMAT_decimal(a_sink, (uint16)value, FALSE, fraction, width, pad);
+	}
+}
+
+/*
+ * Description:
+ * Send a hexadecimal number in upper case with exactly the given number of digits (1 to 4).
+ */
+void FORMAT_hex(FORMAT_Sink a_sink, uint16 value, uint8 digits)
+{
+	uint8 nibble;
+
+	if(digits > 4)
+	{
+		digits = 4;
+	}
+
+	while(digits != 0)
+	{
+		digits--;
+		nibble = (uint8)(value >> (digits * 4)) & 0x0F;
+		a_sink((nibble < 10) ? ('0' + nibble) : ('A' - 10 + nibble));
+	}
+}
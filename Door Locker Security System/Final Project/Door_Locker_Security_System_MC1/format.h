@@ -0,0 +1,67 @@
+/****************************************************************************************
+ *
+ * Module: Format
+ *
+ * File Name: format.h
+ *
+ * Discretion: Header file for the number formatting. The digits are sent one by one to a
+ * 			   character sink (LCD or framebuffer) without any string buffer or stdlib call.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* Padding characters of the width */
+#define FORMAT_PAD_SPACE				' '
+#define FORMAT_PAD_ZERO					'0'
+
+/* Maximum number of fraction digits of FORMAT_fixed() */
+#define FORMAT_MAX_FRACTION				4
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* Function that takes the formatted characters, e.g. LCD_displayCharacter or FRAMEBUFFER_displayCharacter */
+typedef void (*FORMAT_Sink)(uint8 character);
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Send an unsigned decimal number. If it is shorter than the width, it is padded on the left
+ * with FORMAT_PAD_SPACE or FORMAT_PAD_ZERO. Width 0 sends only the digits.
+ */
+void FORMAT_unsigned(FORMAT_Sink a_sink, uint16 value, uint8 width, uint8 pad);
+
+/*
+ * Description:
+ * Send a signed decimal number. The '-' is put before zero padding and after space padding.
+ */
+void FORMAT_signed(FORMAT_Sink a_sink, sint16 value, uint8 width, uint8 pad);
+
+/*
+ * Description:
+ * Send a fixed-point number: the value is the real number multiplied by 10^fraction.
+ * e.g. value 1234 with fraction 2 is sent as "12.34" and -5 with fraction 1 as "-0.5".
+ */
+void FORMAT_fixed(FORMAT_Sink a_sink, sint16 value, uint8 fraction, uint8 width, uint8 pad);
+
+/*
+ * Description:
+ * Send a hexadecimal number in upper case with exactly the given number of digits (1 to 4).
+ */
+void FORMAT_hex(FORMAT_Sink a_sink, uint16 value, uint8 digits);
+
+#endif /* FORMAT_H_ */
@@ -13,6 +13,21 @@
 #include <avr/io.h> /* To use the IO Ports Registers */
 #include "common_macros.h" /* To use Macros as SET_BIT */
 #include "gpio.h"
+#include "ring_buffer.h"
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Call back function of each external interrupt line */
+static void (*volatile g_interruptCallBackPtr[NUM_OF_EXTERNAL_INTERRUPTS])(void) = {NULL_PTR, NULL_PTR, NULL_PTR};
+
+RING_BUFFER_DEFINE(g_interruptEvents, GPIO_EVENTS_SIZE);	/* Line numbers of the interrupts that the main loop did not take yet. */
+
+/*******************************************************************************
+ *                      	Function Prototypes                                *
+ *******************************************************************************/
+static void GPIO_interruptEvent(GPIO_ExternalInterruptType line);
 
 /*
  * Description:
@@ -292,3 +307,141 @@ uint8 GPIO_readPort(uint8 port_num)
 	}
 	return port_value;
 }
+
+/*
+ * Description:
+ * Write the bits of value selected by mask on the required port, the other pins keep their values.
+ * All the selected pins change in one store and an ISR can not change the port in between.
+ * If the input port number is not correct, the function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+	if(port_num >= NUM_OF_PORTS)
+	{
+		/* Do nothing */
+	}
+	else
+	{
+		GPIO_writeMaskedFast(port_num, mask, value);
+	}
+}
+
+/*
+ * Description:
+ * Make the pin of the external interrupt line an input and enable the interrupt on the required sense.
+ * Each interrupt calls the call back function (if it is not NULL_PTR) from the ISR and adds an event
+ * for the main loop to GPIO_getInterruptEvent(). The pull-up resistor is left to the application.
+ * If the line number is not correct, or the sense is not supported on INT2, the function will not handle the request.
+ */
+void GPIO_enableExternalInterrupt(GPIO_ExternalInterruptType line, GPIO_InterruptSenseType sense, void(*a_ptr)(void))
+{
+	uint8 sreg;
+
+	if((line >= NUM_OF_EXTERNAL_INTERRUPTS) || ((line == GPIO_INT2) && (sense < GPIO_FALLING_EDGE)))
+	{
+		/* Do nothing */
+		return;
+	}
+
+	/* The line is disabled while its sense changes, a change of the sense can set the flag by itself */
+	GPIO_disableExternalInterrupt(line);
+	g_interruptCallBackPtr[line] = a_ptr;
+
+	sreg = SYNC_enterCritical();
+	switch(line)
+	{
+	case GPIO_INT0:
+		GPIO_setupPinDirectionFast(INT0_PORT_ID, INT0_PIN_ID, PIN_INPUT);
+		MCUCR = (MCUCR & 0xFC) | ((sense & 0x03)<<ISC00);
+		GIFR = (1<<INTF0);		/* Clear the old flag by writing one */
+		SET_BIT(GICR, INT0);
+		break;
+	case GPIO_INT1:
+		GPIO_setupPinDirectionFast(INT1_PORT_ID, INT1_PIN_ID, PIN_INPUT);
+		MCUCR = (MCUCR & 0xF3) | ((sense & 0x03)<<ISC10);
+		GIFR = (1<<INTF1);
+		SET_BIT(GICR, INT1);
+		break;
+	case GPIO_INT2:
+		GPIO_setupPinDirectionFast(INT2_PORT_ID, INT2_PIN_ID, PIN_INPUT);
+		MCUCSR = (MCUCSR & ~(1<<ISC2)) | ((sense & 0x01)<<ISC2);
+		GIFR = (1<<INTF2);
+		SET_BIT(GICR, INT2);
+		break;
+	}
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Disable the external interrupt line. Its events that are still waiting are kept.
+ */
+void GPIO_disableExternalInterrupt(GPIO_ExternalInterruptType line)
+{
+	uint8 sreg = SYNC_enterCritical();
+
+	switch(line)
+	{
+	case GPIO_INT0:
+		CLEAR_BIT(GICR, INT0);
+		break;
+	case GPIO_INT1:
+		CLEAR_BIT(GICR, INT1);
+		break;
+	case GPIO_INT2:
+		CLEAR_BIT(GICR, INT2);
+		break;
+	}
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Take the oldest external interrupt event, the line number is written in line_ptr.
+ * Return FALSE if no event is waiting.
+ */
+uint8 GPIO_getInterruptEvent(GPIO_ExternalInterruptType *a_line_ptr)
+{
+	uint8 line;
+
+	if(RING_BUFFER_pop(&g_interruptEvents, &line) == FALSE)
+	{
+		return FALSE;
+	}
+	*a_line_ptr = (GPIO_ExternalInterruptType)line;
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Called from the ISR of each line: call the application and add the event for the main loop.
+ * If the events buffer is full, the new event is dropped (the main loop is already behind on this input).
+ */
+static void GPIO_interruptEvent(GPIO_ExternalInterruptType line)
+{
+	void (*callBack)(void) = g_interruptCallBackPtr[line];
+
+	if(callBack != NULL_PTR)
+	{
+		(*callBack)();
+	}
+	RING_BUFFER_push(&g_interruptEvents, line);
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(INT0_vect)
+{
+	GPIO_interruptEvent(GPIO_INT0);
+}
+
+ISR(INT1_vect)
+{
+	GPIO_interruptEvent(GPIO_INT1);
+}
+
+ISR(INT2_vect)
+{
+	GPIO_interruptEvent(GPIO_INT2);
+}
@@ -18,6 +18,9 @@
  *  						(1) Include Header					   *
  *******************************************************************/
 #include "std_types.h"
+#include "common_macros.h"
+#include "sync.h"
+#include <avr/io.h>
 
 /*******************************************************************
  *  						(2) Definitions						   *
@@ -39,6 +42,18 @@
 #define PIN6_ID 				6
 #define PIN7_ID 				7
 
+/* External interrupt lines of ATmega16 and their pins */
+#define NUM_OF_EXTERNAL_INTERRUPTS	3
+#define INT0_PORT_ID			PORTD_ID
+#define INT0_PIN_ID				PIN2_ID
+#define INT1_PORT_ID			PORTD_ID
+#define INT1_PIN_ID				PIN3_ID
+#define INT2_PORT_ID			PORTB_ID
+#define INT2_PIN_ID				PIN2_ID
+
+/* Number of interrupt events that can wait for the main loop (power of two) */
+#define GPIO_EVENTS_SIZE		8
+
 /*******************************************************************
  *  						(3) Type Deceleration				   *
  *******************************************************************/
@@ -50,6 +65,15 @@ typedef enum
 {
 	PORT_INPUT,PORT_OUTPUT=0xFF
 }GPIO_PortDirectionType;
+typedef enum
+{
+	GPIO_INT0,GPIO_INT1,GPIO_INT2
+}GPIO_ExternalInterruptType;
+/* Same values as the ISCn1:ISCn0 bits. INT2 supports only GPIO_FALLING_EDGE and GPIO_RISING_EDGE. */
+typedef enum
+{
+	GPIO_LOW_LEVEL,GPIO_ANY_EDGE,GPIO_FALLING_EDGE,GPIO_RISING_EDGE
+}GPIO_InterruptSenseType;
 
 /*******************************************************************
  *  						(5) Function Prototypes				   *
@@ -102,4 +126,162 @@ void GPIO_writePort(uint8 port_num, uint8 value);
  */
 uint8 GPIO_readPort(uint8 port_num);
 
+/*
+ * Description:
+ * Write the bits of value selected by mask on the required port, the other pins keep their values.
+ * All the selected pins change in one store and an ISR can not change the port in between.
+ * If the input port number is not correct, the function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value);
+
+/*
+ * Description:
+ * Make the pin of the external interrupt line an input and enable the interrupt on the required sense.
+ * Each interrupt calls the call back function (if it is not NULL_PTR) from the ISR and adds an event
+ * for the main loop to GPIO_getInterruptEvent(). The pull-up resistor is left to the application.
+ * If the line number is not correct, or the sense is not supported on INT2, the function will not handle the request.
+ */
+void GPIO_enableExternalInterrupt(GPIO_ExternalInterruptType line, GPIO_InterruptSenseType sense, void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Disable the external interrupt line. Its events that are still waiting are kept.
+ */
+void GPIO_disableExternalInterrupt(GPIO_ExternalInterruptType line);
+
+/*
+ * Description:
+ * Take the oldest external interrupt event, the line number is written in line_ptr.
+ * Return FALSE if no event is waiting.
+ */
+uint8 GPIO_getInterruptEvent(GPIO_ExternalInterruptType *a_line_ptr);
+
+/*******************************************************************
+ *  				(6) Compile-time Pin Access					   *
+ *******************************************************************/
+/*
+ * The functions below are for pins known at compile time (PORTx_ID and PINx_ID constants).
+ * After inlining the switch disappears and each pin access becomes one sbi, cbi or sbis/sbic
+ * instruction. They do not check the numbers, so use the functions above for pins chosen at run time.
+ */
+
+/*
+ * Description:
+ * Return the address of the PORT, DDR or PIN register of the port.
+ */
+static inline __attribute__((always_inline)) volatile uint8 *GPIO_portRegister(uint8 port_num)
+{
+	switch(port_num)
+	{
+	case PORTA_ID: return &PORTA;
+	case PORTB_ID: return &PORTB;
+	case PORTC_ID: return &PORTC;
+	default:	   return &PORTD;
+	}
+}
+
+static inline __attribute__((always_inline)) volatile uint8 *GPIO_ddrRegister(uint8 port_num)
+{
+	switch(port_num)
+	{
+	case PORTA_ID: return &DDRA;
+	case PORTB_ID: return &DDRB;
+	case PORTC_ID: return &DDRC;
+	default:	   return &DDRD;
+	}
+}
+
+static inline __attribute__((always_inline)) volatile uint8 *GPIO_pinRegister(uint8 port_num)
+{
+	switch(port_num)
+	{
+	case PORTA_ID: return &PINA;
+	case PORTB_ID: return &PINB;
+	case PORTC_ID: return &PINC;
+	default:	   return &PIND;
+	}
+}
+
+/*
+ * Description:
+ * Same as GPIO_setupPinDirection() for a constant pin.
+ */
+static inline __attribute__((always_inline)) void GPIO_setupPinDirectionFast(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType direction)
+{
+	if(direction == PIN_OUTPUT)
+	{
+		SET_BIT(*GPIO_ddrRegister(port_num), pin_num);
+	}
+	else
+	{
+		CLEAR_BIT(*GPIO_ddrRegister(port_num), pin_num);
+	}
+}
+
+/*
+ * Description:
+ * Same as GPIO_writePin() for a constant pin. A constant value gives one instruction,
+ * a variable value gives a branch to one of two instructions.
+ */
+static inline __attribute__((always_inline)) void GPIO_writePinFast(uint8 port_num, uint8 pin_num, uint8 value)
+{
+	if(value == LOGIC_HIGH)
+	{
+		SET_BIT(*GPIO_portRegister(port_num), pin_num);
+	}
+	else
+	{
+		CLEAR_BIT(*GPIO_portRegister(port_num), pin_num);
+	}
+}
+
+/*
+ * Description:
+ * Same as GPIO_readPin() for a constant pin.
+ */
+static inline __attribute__((always_inline)) uint8 GPIO_readPinFast(uint8 port_num, uint8 pin_num)
+{
+	return BIT_IS_SET(*GPIO_pinRegister(port_num), pin_num) ? LOGIC_HIGH : LOGIC_LOW;
+}
+
+/*
+ * Description:
+ * Same as GPIO_setupPortDirection() for a constant port.
+ */
+static inline __attribute__((always_inline)) void GPIO_setupPortDirectionFast(uint8 port_num, GPIO_PortDirectionType direction)
+{
+	*GPIO_ddrRegister(port_num) = direction;
+}
+
+/*
+ * Description:
+ * Same as GPIO_writePort() for a constant port.
+ */
+static inline __attribute__((always_inline)) void GPIO_writePortFast(uint8 port_num, uint8 value)
+{
+	*GPIO_portRegister(port_num) = value;
+}
+
+/*
+ * Description:
+ * Same as GPIO_writeMasked() for a constant port.
+ */
+static inline __attribute__((always_inline)) void GPIO_writeMaskedFast(uint8 port_num, uint8 mask, uint8 value)
+{
+	volatile uint8 *port_ptr = GPIO_portRegister(port_num);
+	uint8 sreg = SYNC_enterCritical();
+
+	*port_ptr = (*port_ptr & (uint8)~mask) | (value & mask);
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Same as GPIO_readPort() for a constant port.
+ */
+static inline __attribute__((always_inline)) uint8 GPIO_readPortFast(uint8 port_num)
+{
+	return *GPIO_pinRegister(port_num);
+}
+
 #endif /* GPIO_ */
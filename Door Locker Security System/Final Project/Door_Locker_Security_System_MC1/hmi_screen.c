@@ -0,0 +1,77 @@
+/****************************************************************************************
+ *
+ * Module: HMI Screen
+ *
+ * File Name: hmi_screen.c
+ *
+ * Discretion: Source file for the screen engine
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "hmi_screen.h"
+#include "lcd_framebuffer.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Write the screen in the framebuffer and move the cursor to its input place.
+ * Only the cells that differ from the last screen are sent to the LCD by the next flush.
+ */
+void SCREEN_show(const SCREEN_Type *a_screen_ptr)
+{
+	const SCREEN_Item *item = (const SCREEN_Item *)pgm_read_ptr(&a_screen_ptr->items);
+	uint8 count = pgm_read_byte(&a_screen_ptr->itemCount);
+	uint8 row;
+
+	/* The framebuffer is cleared in RAM only, the LCD is not cleared */
+	FRAMEBUFFER_clear();
+
+	for(; count != 0; count--, item++)
+	{
+		FRAMEBUFFER_displayStringRowColumn_P(pgm_read_byte(&item->row), pgm_read_byte(&item->col), TEXT_get((TEXT_Id)pgm_read_byte(&item->text)));
+	}
+
+	/* The next written characters go to the input place */
+	row = pgm_read_byte(&a_screen_ptr->cursorRow);
+	if(row != SCREEN_NO_CURSOR)
+	{
+		FRAMEBUFFER_moveCursor(row, pgm_read_byte(&a_screen_ptr->cursorCol));
+	}
+}
+
+/*
+ * Description:
+ * Return the action selected by a key on the screen, or SCREEN_NO_ACTION if the screen does not accept this key.
+ */
+uint8 SCREEN_getAction(const SCREEN_Type *a_screen_ptr, uint8 key)
+{
+	const SCREEN_MenuItem *menuItem = (const SCREEN_MenuItem *)pgm_read_ptr(&a_screen_ptr->menu);
+	uint8 count = pgm_read_byte(&a_screen_ptr->menuCount);
+
+	for(; count != 0; count--, menuItem++)
+	{
+		if(pgm_read_byte(&menuItem->key) == key)
+		{
+			return pgm_read_byte(&menuItem->action);
+		}
+	}
+
+	return SCREEN_NO_ACTION;
+}
+
+/*
+ * Description:
+ * Return the time of presenting the screen in ms, 0 if the screen is not timed.
+ */
+uint16 SCREEN_getTimeout(const SCREEN_Type *a_screen_ptr)
+{
+	return pgm_read_word(&a_screen_ptr->timeout);
+}
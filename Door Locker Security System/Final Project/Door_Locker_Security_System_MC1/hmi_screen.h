@@ -0,0 +1,81 @@
+/****************************************************************************************
+ *
+ * Module: HMI Screen
+ *
+ * File Name: hmi_screen.h
+ *
+ * Discretion: Header file for the screen engine. Each screen is a constant table in flash
+ * 			   of the text on it, the keys it accepts and the time it is presented.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef HMI_SCREEN_H_
+#define HMI_SCREEN_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+#include "hmi_text.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SCREEN_NO_CURSOR				0xFF		/* The screen does not take any written input. */
+#define SCREEN_NO_ACTION				0xFF		/* Returned for a key that the screen does not accept. */
+
+/* Number of entries of a constant array, to fill the counts of SCREEN_Type */
+#define SCREEN_COUNT_OF(array)			(sizeof(array) / sizeof((array)[0]))
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* One text on the screen */
+typedef struct{
+	uint8 row;
+	uint8 col;
+	TEXT_Id text;
+}SCREEN_Item;
+
+/* One key accepted by the screen and the action of the application it selects */
+typedef struct{
+	uint8 key;
+	uint8 action;
+}SCREEN_MenuItem;
+
+/* A screen, it must be saved in flash (PROGMEM) with its items and menu */
+typedef struct{
+	const SCREEN_Item *items;
+	uint8 itemCount;
+	const SCREEN_MenuItem *menu;			/* NULL_PTR if the screen accepts no option keys. */
+	uint8 menuCount;
+	uint8 cursorRow;						/* Place of the written input, SCREEN_NO_CURSOR if there is no input. */
+	uint8 cursorCol;
+	uint16 timeout;							/* Time of presenting a message in ms, 0 if the screen is not timed. */
+}SCREEN_Type;
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Write the screen in the framebuffer and move the cursor to its input place.
+ * Only the cells that differ from the last screen are sent to the LCD by the next flush.
+ */
+void SCREEN_show(const SCREEN_Type *a_screen_ptr);
+
+/*
+ * Description:
+ * Return the action selected by a key on the screen, or SCREEN_NO_ACTION if the screen does not accept this key.
+ */
+uint8 SCREEN_getAction(const SCREEN_Type *a_screen_ptr, uint8 key);
+
+/*
+ * Description:
+ * Return the time of presenting the screen in ms, 0 if the screen is not timed.
+ */
+uint16 SCREEN_getTimeout(const SCREEN_Type *a_screen_ptr);
+
+#endif /* HMI_SCREEN_H_ */
@@ -0,0 +1,75 @@
+/****************************************************************************************
+ *
+ * Module: HMI Text
+ *
+ * File Name: hmi_text.c
+ *
+ * Discretion: Source file for the table of all text presented by the HMI
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "hmi_text.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Each text is written one time only, even if it is presented on several screens */
+static const uint8 TEXT_savePassword[] PROGMEM 				= "Save Password:";
+static const uint8 TEXT_repeatPassword[] PROGMEM 			= "Repeat Password:";
+static const uint8 TEXT_repeatedPassword[] PROGMEM 			= "Repeated Password";
+static const uint8 TEXT_isWrong[] PROGMEM 					= "is Wrong";
+static const uint8 TEXT_repeatThe[] PROGMEM 				= "Repeat the";
+static const uint8 TEXT_process[] PROGMEM 					= "Process";
+static const uint8 TEXT_openDoorOption[] PROGMEM 			= "+: Open Door";
+static const uint8 TEXT_changePasswordOption[] PROGMEM 		= "-: Change Pass";
+static const uint8 TEXT_enterPassword[] PROGMEM 			= "Enter Password:";
+static const uint8 TEXT_openingDoor[] PROGMEM 				= "Opening the door";
+static const uint8 TEXT_holdingDoor[] PROGMEM 				= "Holding the door";
+static const uint8 TEXT_closingDoor[] PROGMEM 				= "Closing the door";
+static const uint8 TEXT_wrongPassword[] PROGMEM 			= "Wrong Password";
+static const uint8 TEXT_error[] PROGMEM 					= "ERROR!!";
+static const uint8 TEXT_doorFault[] PROGMEM 				= "Door Fault";
+static const uint8 TEXT_doorBusy[] PROGMEM 					= "Door Busy";
+static const uint8 TEXT_noReply[] PROGMEM 					= "No Reply";
+static const uint8 TEXT_faultOptions[] PROGMEM 				= "+:Close -:Menu";
+
+/* Table of the text addresses, in the same order as TEXT_Id */
+static const uint8 * const TEXT_table[TEXT_COUNT] PROGMEM =
+{
+	TEXT_savePassword,
+	TEXT_repeatPassword,
+	TEXT_repeatedPassword,
+	TEXT_isWrong,
+	TEXT_repeatThe,
+	TEXT_process,
+	TEXT_openDoorOption,
+	TEXT_changePasswordOption,
+	TEXT_enterPassword,
+	TEXT_openingDoor,
+	TEXT_holdingDoor,
+	TEXT_closingDoor,
+	TEXT_wrongPassword,
+	TEXT_error,
+	TEXT_doorFault,
+	TEXT_doorBusy,
+	TEXT_noReply,
+	TEXT_faultOptions
+};
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Return the flash address of a text, to be presented with the _P functions of the LCD and the framebuffer.
+ */
+const uint8 *TEXT_get(TEXT_Id id)
+{
+	return (const uint8 *)pgm_read_ptr(&TEXT_table[id]);
+}
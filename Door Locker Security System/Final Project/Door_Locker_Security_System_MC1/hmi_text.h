@@ -0,0 +1,56 @@
+/****************************************************************************************
+ *
+ * Module: HMI Text
+ *
+ * File Name: hmi_text.h
+ *
+ * Discretion: Header file for the table of all text presented by the HMI.
+ * 			   The text is kept in flash only, so it takes no SRAM.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef HMI_TEXT_H_
+#define HMI_TEXT_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	TEXT_SAVE_PASSWORD,
+	TEXT_REPEAT_PASSWORD,
+	TEXT_REPEATED_PASSWORD,
+	TEXT_IS_WRONG,
+	TEXT_REPEAT_THE,
+	TEXT_PROCESS,
+	TEXT_OPEN_DOOR_OPTION,
+	TEXT_CHANGE_PASSWORD_OPTION,
+	TEXT_ENTER_PASSWORD,
+	TEXT_OPENING_DOOR,
+	TEXT_HOLDING_DOOR,
+	TEXT_CLOSING_DOOR,
+	TEXT_WRONG_PASSWORD,
+	TEXT_ERROR,
+	TEXT_DOOR_FAULT,
+	TEXT_DOOR_BUSY,
+	TEXT_NO_REPLY,
+	TEXT_FAULT_OPTIONS,
+	TEXT_COUNT
+}TEXT_Id;
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Return the flash address of a text, to be presented with the _P functions of the LCD and the framebuffer.
+ */
+const uint8 *TEXT_get(TEXT_Id id);
+
+#endif /* HMI_TEXT_H_ */
@@ -13,21 +13,60 @@
 
 #include "keypad.h"
 #include "gpio.h"
-#include <avr\io.h>
+#include "ring_buffer.h"
+#include "sync.h"
+#include <avr/io.h>
+#include <util/delay.h>
+
+/* Each queued event is one byte: the event type in the last two bits and the key index (bit in the scan bitmap) in the others */
+#define KEYPAD_EVENT_TYPE_SHIFT			6
+#define KEYPAD_EVENT_INDEX_MASK			0x3F
+
+#if (NUMBER_OF_COLUMNS != 4) || (NUMBER_OF_ROW != 4)
+#error "The keymaps are written for a 4x4 scan"
+#endif
+
+/* Row pins in the port and the value of a pressed row after reading the port */
+#define KEYPAD_ROWS_MASK				(((1 << NUMBER_OF_ROW) - 1) << KEYPAD_FIRST_ROW_PIN)
+
+/* Global variables used by the background scan, written only by KEYPAD_scanTick() after KEYPAD_init() */
+RING_BUFFER_DEFINE(g_keypadEvents, KEYPAD_EVENTS_SIZE);			/* Events from the timer ISR to the main loop. */
+static uint8 g_keypadScanTimer = 0;								/* Number of ticks left before the next scan. */
+static uint8 g_keypadDebounce[KEYPAD_NUMBER_OF_KEYS];			/* For each key, count up while pressed and down while released (0 ~ KEYPAD_DEBOUNCE_SCANS). */
+static volatile uint16 g_keypadPressed = 0;						/* Debounced state of each key, one bit for each key index. */
+static uint8 g_keypadRepeatIndex = KEYPAD_NO_KEY;				/* Index of the last pressed key that is still held, it is the one auto-repeated. */
+static uint8 g_keypadRepeatTimer = 0;							/* Number of scans left before the next auto-repeat. */
+static const uint8 *g_keypadKeymap = KEYPAD_DEFAULT_KEYMAP;		/* Keymap in flash used by the main loop to translate the keys. */
+
+/*
+ * The keymaps are column by column, the same order as the bits of the scan bitmap.
+ * The 4x3 keypad has no operator keys: '*' gives '-' and '#' gives '+', the two option keys of the HMI.
+ */
+const uint8 KEYPAD_keymap4x3[KEYPAD_NUMBER_OF_KEYS] PROGMEM =
+{
+	1,   4,   7,   '-',														/* First column ('*' key) */
+	2,   5,   8,   0,
+	3,   6,   9,   '+',														/* '#' key */
+	KEYPAD_NO_KEY, KEYPAD_NO_KEY, KEYPAD_NO_KEY, KEYPAD_NO_KEY					/* Not connected on the 4x3 keypad */
+};
+
+const uint8 KEYPAD_keymap4x4[KEYPAD_NUMBER_OF_KEYS] PROGMEM =
+{
+	7,   4,   1,   13,														/* First column (13 is the ASCII of enter) */
+	8,   5,   2,   0,
+	9,   6,   3,   '=',
+	'%', '*', '-', '+'
+};
 
-#if (NUMBER_OF_COLUMNS == 3)
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
+ * Map the key index (bit in the scan bitmap) to its value on the keypad.
  */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
-#elif (NUMBER_OF_COLUMNS == 4)
+static uint8 KEYPAD_mapIndex(uint8 index);
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
+ * Add an event to the queue from the timer ISR. The event is lost if the main loop left the queue full.
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
-#endif
+static void KEYPAD_pushEvent(KEYPAD_EventType type, uint8 index);
 
 /*
  * Description:
@@ -36,137 +75,239 @@ static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
  */
 uint8 KEYPAD_getPressedKey(void)
 {
-	uint8 col, row;
-	uint8 keypad_port_value = 0;
+	uint8 key;
 
-	while(1)
+	/* Scan the keypad again and again until a button is pressed */
+	do
 	{
-		/* This will loop on the keypad columns */
-		for(col=0;col<NUMBER_OF_COLUMNS;col++)
-		{
-			/* Make the whole port output and change direction of a certain pin each loop to output */
-			GPIO_setupPortDirection(KEYPAD_PORT_ID , PORT_INPUT);
-			GPIO_setupPinDirection(KEYPAD_PORT_ID , col + PIN4_ID, PIN_OUTPUT);
-
-			/*
-			 * This value will make that certain pin value equal to 0 while the other values of the whole port equal to 1
-			 * The AVR open internal pull up when we put ones in pins 0 ~ 3
-			 */
+		key = KEYPAD_readKey();
+	}while(key == KEYPAD_NO_KEY);
+
+	return key;
+}
+
+/*
+ * Description:
+ * Scan the keypad one time without waiting.
+ * Return the value of the pressed button or KEYPAD_NO_KEY if no button is pressed.
+ */
+uint8 KEYPAD_readKey(void)
+{
+	uint16 bitmap = KEYPAD_scanMatrix();
+	uint8 index = 0;
+
+	/* No button is pressed */
+	if(bitmap == 0)
+	{
+		return KEYPAD_NO_KEY;
+	}
+
+	/* Take the first pressed button */
+	while(!(bitmap & 1))
+	{
+		bitmap >>= 1;
+		index++;
+	}
+
+	return KEYPAD_mapIndex(index);
+}
+
+/*
+ * Description:
+ * Scan the whole matrix with one port write and one port read for each column.
+ * Return a bitmap of all pressed buttons, the bit of each button is (column * NUMBER_OF_ROW + row).
+ */
+uint16 KEYPAD_scanMatrix(void)
+{
+	uint16 bitmap = 0;
+	uint8 col = NUMBER_OF_COLUMNS;
+	uint8 rows;
+
+	/* Start from the last column, so each column is shifted to its place by the next ones */
+	do
+	{
+		col--;
+
+		/*
+		 * Only the current column is output. For pull-up (active low) buttons it is driven low
+		 * while the ones on the rows open the internal pull ups.
+		 */
+		KEYPAD_DDR_REG = (1 << (col + KEYPAD_FIRST_COLUMN_BIN));
 #if(BUTTON_IS_PRESSED == LOGIC_LOW)
-			keypad_port_value = ~(1<<(col + PIN4_ID));
+		KEYPAD_PORT_REG = (uint8)~(1 << (col + KEYPAD_FIRST_COLUMN_BIN));
 #elif(BUTTON_IS_PRESSED == LOGIC_HIGH)
-			keypad_port_value = (1<<(col + PIN4_ID));
+		KEYPAD_PORT_REG = (1 << (col + KEYPAD_FIRST_COLUMN_BIN));
 #endif
-			/* Write the value in the port */
-			GPIO_writePort(KEYPAD_PORT_ID , keypad_port_value);
+		/* Let the rows settle to the new column (one cycle is enough for the input synchronizer only) */
+		_delay_us(KEYPAD_SETTLE_US);
 
-			/* This will loop on keypad rows */
-			for(row=0;row<NUMBER_OF_ROW;row++)
-			{
-				/* Check for each row if the button is pressed */
-				if(GPIO_readPin(KEYPAD_PORT_ID ,row) == BUTTON_IS_PRESSED)
-				{
-					/* Return button number */
-#if(NUMBER_OF_COLUMNS == 3)
-					return KEYPAD_4x3_adjustKeyNumber((row*NUMBER_OF_COLUMNS)+col+1);
-#elif (NUMBER_OF_COLUMNS == 4)
-					return KEYPAD_4x4_adjustKeyNumber((row*NUMBER_OF_COLUMNS)+col+1);
+		/* Read all rows in one read */
+#if(BUTTON_IS_PRESSED == LOGIC_LOW)
+		rows = ~KEYPAD_PIN_REG;
+#elif(BUTTON_IS_PRESSED == LOGIC_HIGH)
+		rows = KEYPAD_PIN_REG;
 #endif
+		bitmap = (bitmap << NUMBER_OF_ROW) | ((rows & KEYPAD_ROWS_MASK) >> KEYPAD_FIRST_ROW_PIN);
+	}while(col != 0);
 
-				}
+	/* Leave all columns as inputs so no column is driven between scans */
+	KEYPAD_DDR_REG = 0;
+
+	return bitmap;
+}
+
+/*
+ * Description:
+ * Return the debounced bitmap of all held buttons (same bit order as KEYPAD_scanMatrix()), to detect key combinations.
+ */
+uint16 KEYPAD_getPressedKeys(void)
+{
+	return SYNC_readU16(&g_keypadPressed);
+}
+
+/*
+ * Description:
+ * Clear the debounce state and all waiting events.
+ */
+void KEYPAD_init(void)
+{
+	uint8 index;
+	uint8 data;
+	uint8 sreg = SYNC_enterCritical();
+
+	for(index = 0; index < KEYPAD_NUMBER_OF_KEYS; index++)
+	{
+		g_keypadDebounce[index] = 0;
+	}
+	g_keypadPressed = 0;
+	g_keypadRepeatIndex = KEYPAD_NO_KEY;
+	g_keypadScanTimer = 0;
+
+	/* Drop the events left from before */
+	while(RING_BUFFER_pop(&g_keypadEvents, &data)){}
+
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Called from the timer ISR every 1 ms. Scans the keypad every KEYPAD_SCAN_PERIOD calls,
+ * debounces each key and adds press, release and auto-repeat events to the event queue.
+ * KEYPAD_getPressedKey() and KEYPAD_readKey() must not be used while the scan is running from the ISR.
+ */
+void KEYPAD_scanTick(void)
+{
+	uint16 bitmap;
+	uint16 pressed;
+	uint8 index;
+	uint16 bit;
+
+	/* Wait for the next scan time */
+	if(g_keypadScanTimer > 1)
+	{
+		g_keypadScanTimer--;
+		return;
+	}
+	g_keypadScanTimer = KEYPAD_SCAN_PERIOD;
+
+	bitmap = KEYPAD_scanMatrix();
+	pressed = g_keypadPressed;
+
+	for(index = 0, bit = 1; index < KEYPAD_NUMBER_OF_KEYS; index++, bit <<= 1)
+	{
+		/* Count up while the key is pressed and down while it is released, so a short bounce does not change its state */
+		if(bitmap & bit)
+		{
+			if(g_keypadDebounce[index] < KEYPAD_DEBOUNCE_SCANS)
+			{
+				g_keypadDebounce[index]++;
+			}
+		}
+		else if(g_keypadDebounce[index] > 0)
+		{
+			g_keypadDebounce[index]--;
+		}
+
+		/* The key is stable pressed for the first time */
+		if((g_keypadDebounce[index] == KEYPAD_DEBOUNCE_SCANS) && !(pressed & bit))
+		{
+			pressed |= bit;
+			g_keypadRepeatIndex = index;
+			g_keypadRepeatTimer = KEYPAD_REPEAT_DELAY;
+			KEYPAD_pushEvent(KEYPAD_PRESS, index);
+		}
+		/* The key is stable released for the first time */
+		else if((g_keypadDebounce[index] == 0) && (pressed & bit))
+		{
+			pressed &= ~bit;
+			if(g_keypadRepeatIndex == index)
+			{
+				g_keypadRepeatIndex = KEYPAD_NO_KEY;
 			}
+			KEYPAD_pushEvent(KEYPAD_RELEASE, index);
+		}
+	}
+
+	g_keypadPressed = pressed;
+
+	/* Auto-repeat the held key */
+	if(g_keypadRepeatIndex != KEYPAD_NO_KEY)
+	{
+		g_keypadRepeatTimer--;
+		if(g_keypadRepeatTimer == 0)
+		{
+			g_keypadRepeatTimer = KEYPAD_REPEAT_RATE;
+			KEYPAD_pushEvent(KEYPAD_REPEAT, g_keypadRepeatIndex);
 		}
 	}
 }
 
-#if(NUMBER_OF_COLUMNS == 3)
 /*
- * This function used to adjust the buttons in 4x3 keypad to its right presentation.
+ * Description:
+ * Take the oldest keypad event without waiting.
+ * Return TRUE if an event is written in a_event_ptr, FALSE if no event is waiting.
  */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
+uint8 KEYPAD_getEvent(KEYPAD_Event *a_event_ptr)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
+	uint8 data;
+
+	while(RING_BUFFER_pop(&g_keypadEvents, &data))
 	{
-	case 10:
-		keypad_button = '*'; // ASCII OF *
-		break;
-	case 11:
-		keypad_button = 0;
-		break;
-	case 12:
-		keypad_button = '#'; // ASCII OF #
-		break;
-	default:
-		keypad_button = button_number;
-		break;
+		a_event_ptr->type = (KEYPAD_EventType)(data >> KEYPAD_EVENT_TYPE_SHIFT);
+		a_event_ptr->key = KEYPAD_mapIndex(data & KEYPAD_EVENT_INDEX_MASK);
+
+		/* Skip the keys that have no value in the current keymap */
+		if(a_event_ptr->key != KEYPAD_NO_KEY)
+		{
+			return TRUE;
+		}
 	}
-	return keypad_button;
+
+	return FALSE;
 }
 
+/*
+ * Description:
+ * Select the keymap used to translate the keys, a_keymap_ptr is a table of KEYPAD_NUMBER_OF_KEYS bytes in flash.
+ */
+void KEYPAD_setKeymap(const uint8 *a_keymap_ptr)
+{
+	g_keypadKeymap = a_keymap_ptr;
+}
 
+/*
+ * Map the key index (bit in the scan bitmap) to its value on the keypad.
+ */
+static uint8 KEYPAD_mapIndex(uint8 index)
+{
+	/* One flash read, the same time for all keys */
+	return pgm_read_byte(&g_keypadKeymap[index]);
+}
 
-#elif (NUMBER_OF_COLUMNS == 4)
 /*
- * This function used to adjust the buttons in 4x4 keypad to its right presentation.
+ * Add an event to the queue from the timer ISR. The event is lost if the main loop left the queue full.
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
+static void KEYPAD_pushEvent(KEYPAD_EventType type, uint8 index)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-	case 1:
-		keypad_button = 7;
-		break;
-	case 2:
-		keypad_button = 8;
-		break;
-	case 3:
-		keypad_button = 9;
-		break;
-	case 4:
-		keypad_button = '%';  /* ASCII of "%" */
-		break;
-	case 5:
-		keypad_button = 4;
-		break;
-	case 6:
-		keypad_button = 5;
-		break;
-	case 7:
-		keypad_button = 6;
-		break;
-	case 8:
-		keypad_button = '*';  /* ASCII of "*" */
-		break;
-	case 9:
-		keypad_button = 1;
-		break;
-	case 10:
-		keypad_button = 2;
-		break;
-	case 11:
-		keypad_button = 3;
-		break;
-	case 12:
-		keypad_button = '-';
-		break;
-	case 13:
-		keypad_button = 13; /* ASCII of enter */
-		break;
-	case 14:
-		keypad_button = 0;
-		break;
-	case 15:
-		keypad_button = '=';  /* ASCII of "=" */
-		break;
-	case 16:
-		keypad_button = '+';  /* ASCII of "+" */
-		break;
-	default:
-		keypad_button = button_number;
-		break;
-	}
-	return keypad_button;
+	RING_BUFFER_push(&g_keypadEvents, (uint8)((type << KEYPAD_EVENT_TYPE_SHIFT) | index));
 }
-#endif
@@ -18,18 +18,27 @@
  *									 Include Header							  *
  ******************************************************************************/
 #include "std_types.h"
+#include <avr/pgmspace.h>
 
 
 /******************************************************************************
  *									 Definitions							  *
  ******************************************************************************/
-/* Keypad configurations for number of rows and columns */
+/*
+ * Keypad configurations for number of scanned rows and columns.
+ * A 4x3 keypad is scanned as 4x4 with the last column pin not connected, so the same scan works for both.
+ */
 #define NUMBER_OF_COLUMNS					4
 #define NUMBER_OF_ROW 						4
 
 /* Keypad Port Configurations */
 #define KEYPAD_PORT_ID 						PORTA_ID
 
+/* Registers of KEYPAD_PORT_ID, the scan kernel writes and reads them directly */
+#define KEYPAD_DDR_REG						DDRA
+#define KEYPAD_PORT_REG						PORTA
+#define KEYPAD_PIN_REG						PINA
+
 #define KEYPAD_FIRST_ROW_PIN 				PIN0_ID
 #define KEYPAD_FIRST_COLUMN_BIN 			PIN4_ID
 
@@ -37,6 +46,55 @@
 #define BUTTON_IS_PRESSED 					LOGIC_LOW		/* lOGIC_LOW for bull-up & LOGIC_HIGH for bull-down */
 #define BUTTON_IS_RELEASED					LOGIC_HIGH		/* lOGIC_HIGH for bull-up & LOGIC_LOW for bull-down */
 
+/* Value returned by KEYPAD_readKey() when no button is pressed */
+#define KEYPAD_NO_KEY						0xFF
+
+/*
+ * Background scanning configurations, KEYPAD_scanTick() is called every 1 ms by the timer.
+ * All times below are in number of scans.
+ */
+#define KEYPAD_SCAN_PERIOD					5			/* Scan the matrix every 5 ms. */
+#define KEYPAD_DEBOUNCE_SCANS				3			/* A key must be stable for 3 scans (15 ms) to change its state. */
+#define KEYPAD_REPEAT_DELAY					100			/* First auto-repeat after holding the key for 500 ms. */
+#define KEYPAD_REPEAT_RATE					30			/* Next auto-repeats every 150 ms while the key is held. */
+#define KEYPAD_EVENTS_SIZE					8			/* Number of events that can wait for the main loop (power of two). */
+
+/*
+ * Wait after driving a column before reading the rows: the internal pull-up (20k at least) and the wires of
+ * the matrix take a few us to pull a row back high after the previous column, 4 columns cost 4 * 5 us a scan.
+ */
+#define KEYPAD_SETTLE_US					5
+
+#define KEYPAD_NUMBER_OF_KEYS				(NUMBER_OF_COLUMNS * NUMBER_OF_ROW)
+
+/* Keymap used after reset, KEYPAD_setKeymap() selects another one without changing the driver */
+#define KEYPAD_DEFAULT_KEYMAP				KEYPAD_keymap4x4
+
+
+/******************************************************************************
+ *								 Types Declaration							  *
+ ******************************************************************************/
+typedef enum{
+	KEYPAD_PRESS, KEYPAD_RELEASE, KEYPAD_REPEAT
+}KEYPAD_EventType;
+
+typedef struct{
+	KEYPAD_EventType type;
+	uint8 key;			/* The value of the button as returned by KEYPAD_readKey(). */
+}KEYPAD_Event;
+
+
+/******************************************************************************
+ *								 Global Variables							  *
+ ******************************************************************************/
+/*
+ * Keymaps in flash, one value for each key index (column * NUMBER_OF_ROW + row).
+ * Keys that do not exist on the keypad are KEYPAD_NO_KEY. A custom keypad only needs a table like these.
+ * KEYPAD_keymap4x3 reads '*' as '-' and '#' as '+', so the HMI works with both keypads.
+ */
+extern const uint8 KEYPAD_keymap4x3[KEYPAD_NUMBER_OF_KEYS] PROGMEM;
+extern const uint8 KEYPAD_keymap4x4[KEYPAD_NUMBER_OF_KEYS] PROGMEM;
+
 
 /******************************************************************************
  *								 Function Prototypes						  *
@@ -49,4 +107,51 @@
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Description:
+ * Scan the keypad one time without waiting.
+ * Return the value of the pressed button or KEYPAD_NO_KEY if no button is pressed.
+ */
+uint8 KEYPAD_readKey(void);
+
+/*
+ * Description:
+ * Scan the whole matrix with one port write and one port read for each column.
+ * Return a bitmap of all pressed buttons, the bit of each button is (column * NUMBER_OF_ROW + row).
+ */
+uint16 KEYPAD_scanMatrix(void);
+
+/*
+ * Description:
+ * Return the debounced bitmap of all held buttons (same bit order as KEYPAD_scanMatrix()), to detect key combinations.
+ */
+uint16 KEYPAD_getPressedKeys(void);
+
+/*
+ * Description:
+ * Clear the debounce state and all waiting events.
+ */
+void KEYPAD_init(void);
+
+/*
+ * Description:
+ * Select the keymap used to translate the keys, a_keymap_ptr is a table of KEYPAD_NUMBER_OF_KEYS bytes in flash.
+ */
+void KEYPAD_setKeymap(const uint8 *a_keymap_ptr);
+
+/*
+ * Description:
+ * Called from the timer ISR every 1 ms. Scans the keypad every KEYPAD_SCAN_PERIOD calls,
+ * debounces each key and adds press, release and auto-repeat events to the event queue.
+ * KEYPAD_getPressedKey() and KEYPAD_readKey() must not be used while the scan is running from the ISR.
+ */
+void KEYPAD_scanTick(void);
+
+/*
+ * Description:
+ * Take the oldest keypad event without waiting.
+ * Return TRUE if an event is written in a_event_ptr, FALSE if no event is waiting.
+ */
+uint8 KEYPAD_getEvent(KEYPAD_Event *a_event_ptr);
+
 #endif
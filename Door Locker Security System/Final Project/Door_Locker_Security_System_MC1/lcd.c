@@ -16,8 +16,72 @@
 #include "lcd.h"
 #include <avr/io.h>
 #include "gpio.h"
+#include "ring_buffer.h"
+#include "format.h"
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 
+/*
+ * Each queued character is one byte. A command is two bytes, LCD_QUEUE_ESCAPE then the command.
+ * Command 0x00 does not exist, so LCD_QUEUE_ESCAPE twice is the character 0x00 (first CGRAM character).
+ */
+#define LCD_QUEUE_ESCAPE				0x00
+
+/* Number of ticks the busy flag can stay set before the queue stops using it (R/W pin not connected) */
+#define LCD_QUEUE_BUSY_TICKS			10
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_lcdBusyFlagEnabled = FALSE;		/* TRUE if the init found a working busy flag, FALSE again if it never clears. */
+static uint8 g_lcdLastCommandLong = FALSE;		/* TRUE if the last command was clear or return home, used when waiting without the busy flag. */
+
+RING_BUFFER_DEFINE(g_lcdQueue, LCD_QUEUE_SIZE);	/* Commands and characters from the application to the timer ISR. */
+static uint8 g_lcdQueueWait = 0;				/* Ticks to skip after a long command when the busy flag is not used. */
+static uint8 g_lcdQueueBusyTicks = 0;			/* Number of ticks the LCD was found busy one after the other. */
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Wait until the LCD finished the last command or character.
+ * Poll the busy flag, or wait the datasheet execution time if the busy flag is not used.
+ */
+static void LCD_waitReady(void);
+
+/*
+ * Description:
+ * Read the busy flag and address register (RS = 0, R/W = 1).
+ */
+static uint8 LCD_readStatus(void);
+
+/*
+ * Description:
+ * Check the busy flag just after a Clear Display: return TRUE if it reads busy first, then ready in time.
+ */
+static uint8 LCD_checkBusyFlag(void);
+
+/*
+ * Description:
+ * Return the DDRAM address of a row and column.
+ */
+static uint8 LCD_cursorAddress(uint8 row, uint8 col);
+
+/*
+ * Description:
+ * Write a command (rs = LOGIC_LOW) or a character (rs = LOGIC_HIGH) to the LCD without waiting for it to finish.
+ */
+static void LCD_write(uint8 value, uint8 rs);
+
+/*
+ * Description:
+ * Put 4 bits on the data pins D4 --> D7 and pulse the enable pin.
+ */
+#if(LCD_DATA_BITS_MODE == 4)
+static void LCD_writeNibble(uint8 nibble);
+#endif
+
 /*******************************************************************************
  *                      	Function Definitions                               *
  *******************************************************************************/
@@ -28,28 +92,40 @@
 void LCD_init(void)
 {
 	/* Make control pins output */
-	GPIO_setupPinDirection(LCD_RS_PORT_ID, LCD_RS_PIN_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_RW_PORT_ID, LCD_RW_PIN_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_E_PORT_ID, LCD_E_PIN_ID, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_RS_PORT_ID, LCD_RS_PIN_ID, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_RW_PORT_ID, LCD_RW_PIN_ID, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_E_PORT_ID, LCD_E_PIN_ID, PIN_OUTPUT);
+
+	/* The busy flag can not be read before the LCD knows the data bus width, use the datasheet times until then */
+	g_lcdBusyFlagEnabled = FALSE;
+	g_lcdLastCommandLong = FALSE;
+	_delay_ms(LCD_POWER_ON_DELAY_MS);
 #if(LCD_DATA_BITS_MODE == 8)
 	/* Make Data port output */
-	GPIO_setupPortDirection(LCD_DATA_PORT_ID, PORT_OUTPUT);
+	GPIO_setupPortDirectionFast(LCD_DATA_PORT_ID, PORT_OUTPUT);
 
 	LCD_sendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE); /* Two lines 8-bit mode */
 #elif(LCD_DATA_BITS_MODE == 4)
 
 	/* Make Data pins output */
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 0, PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 1, PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 2, PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 3, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 0, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 1, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 2, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 3, PIN_OUTPUT);
 
 	LCD_sendCommand(LCD_RETURN_HOME	);
 	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE); /* Two lines 4-bit mode */
 #endif
+
 	/* Send initial commands */
 	LCD_sendCommand(LCD_CURSOR_OFF); /* Cursor off*/
 	LCD_sendCommand(LCD_CLEAR_SCREEN ); /* Clear Screen */
+
+	/*
+	 * A grounded R/W pin or floating data pins can read "ready" all the time, so the busy flag is used only
+	 * if it is seen busy during the 1.52 ms of the clear. Otherwise the execution times are used from now on.
+	 */
+	g_lcdBusyFlagEnabled = LCD_checkBusyFlag();
 }
 
 /*
@@ -58,57 +134,12 @@ void LCD_init(void)
  */
 void LCD_sendCommand(uint8 command)
 {
-	uint8 lcd_port_value = 0;
-	/* RS = 0  (to send command) and R/W = 0 (to write value) */
-	GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_LOW);
-	GPIO_writePin(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_LOW);
-
-	_delay_ms(1);
-
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH); /* Enable(E) = 1 */
-
-	_delay_ms(1);
-
-#if(LCD_DATA_BITS_MODE == 8)
-	/* Send command */
-	GPIO_writePort(LCD_DATA_PORT_ID, command);
-
-	_delay_ms(1);
-
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); /* Enable(E) = 0 */
-
-	_delay_ms(1);
-#elif(LCD_DATA_BITS_MODE == 4)
-	/* out the last 4 bits of the required command to the data bus D4 --> D7 */
-	lcd_port_value = GPIO_readPort(LCD_DATA_PORT_ID);
-#ifdef LCD_LAST_PORT_PINS
-	lcd_port_value = (lcd_port_value & 0x0F) | (command & 0xF0);
-#else
-	lcd_port_value = (lcd_port_value & 0xF0) | ((command & 0xF0) >> 4);
-#endif
-	GPIO_writePort(LCD_DATA_PORT_ID,lcd_port_value);
-
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1);
-
-	/* out the first 4 bits of the required command to the data bus D4 --> D7 */
-	lcd_port_value = GPIO_readPort(LCD_DATA_PORT_ID);
-#ifdef LCD_LAST_PORT_PINS
-	lcd_port_value = (lcd_port_value & 0x0F) | ((command & 0x0F) << 4);
-#else
-	lcd_port_value = (lcd_port_value & 0xF0) | (command & 0x0F);
-#endif
-	GPIO_writePort(LCD_DATA_PORT_ID,lcd_port_value);
-
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1);
-
-#endif
+	/* Wait for the last operation, then send the command and return while the LCD executes it */
+	LCD_waitReady();
+	LCD_write(command, LOGIC_LOW);
 
+	/* Clear and return home take much longer than the other commands */
+	g_lcdLastCommandLong = (command == LCD_CLEAR_SCREEN) || (command == LCD_RETURN_HOME);
 }
 
 
@@ -118,57 +149,10 @@ void LCD_sendCommand(uint8 command)
  */
 void LCD_displayCharacter(uint8 character)
 {
-	uint8 lcd_port_value = 0;
-	/* RS = 1 (to send character) and R/W = 0 (to write value) */
-	/* RS = 0  (to send command) and R/W = 0 (to write value) */
-	GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_HIGH);
-	GPIO_writePin(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_LOW);
-
-	_delay_ms(1);
-
-	/* Enable(E) = 1 */
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);
-
-	_delay_ms(1);
-
-#if(LCD_DATA_BITS_MODE == 8)
-	/* Send character */
-	GPIO_writePort(LCD_DATA_PORT_ID, character);
-
-	_delay_ms(1);
-
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); /* Enable(E) = 0 */
-
-	_delay_ms(1);
-#elif(LCD_DATA_BITS_MODE == 4)
-	/* out the last 4 bits of the required data to the data bus D4 --> D7 */
-	lcd_port_value = GPIO_readPort(LCD_DATA_PORT_ID);
-#ifdef LCD_LAST_PORT_PINS
-	lcd_port_value = (lcd_port_value & 0x0F) | (character & 0xF0);
-#else
-	lcd_port_value = (lcd_port_value & 0xF0) | ((character & 0xF0) >> 4);
-#endif
-	GPIO_writePort(LCD_DATA_PORT_ID,lcd_port_value);
-
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1);
-
-	/* out the first 4 bits of the required data to the data bus D4 --> D7 */
-	lcd_port_value = GPIO_readPort(LCD_DATA_PORT_ID);
-#ifdef LCD_LAST_PORT_PINS
-	lcd_port_value = (lcd_port_value & 0x0F) | ((character & 0x0F) << 4);
-#else
-	lcd_port_value = (lcd_port_value & 0xF0) | (character & 0x0F);
-#endif
-	GPIO_writePort(LCD_DATA_PORT_ID,lcd_port_value);
-
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1);
-#endif
+	/* Wait for the last operation, then send the character and return while the LCD writes it */
+	LCD_waitReady();
+	LCD_write(character, LOGIC_HIGH);
+	g_lcdLastCommandLong = FALSE;
 }
 
 /*
@@ -190,30 +174,29 @@ void LCD_displayString(const uint8* string)
 
 /*
  * Description:
- * This function move the cursor in memory to choose position on LCD to start with.
+ * Same as LCD_displayString() for a string saved in flash (PROGMEM).
  */
-void LCD_moveCursor(uint8 row, uint8 col)
+void LCD_displayString_P(const uint8* string)
 {
-	uint8 lcd_memory_address;
+	uint8 character = pgm_read_byte(string);
 
-	/* Calculate the required address in the LCD DDRAM */
-	switch(row)
+	/* Read each character from flash until the end of the string */
+	while(character != '\0')
 	{
-		case 0:
-			lcd_memory_address=col;
-				break;
-		case 1:
-			lcd_memory_address=col+0x40;
-				break;
-		case 2:
-			lcd_memory_address=col+0x10;
-				break;
-		case 3:
-			lcd_memory_address=col+0x50;
-				break;
+		LCD_displayCharacter(character);
+		string++;
+		character = pgm_read_byte(string);
 	}
+}
+
+/*
+ * Description:
+ * This function move the cursor in memory to choose position on LCD to start with.
+ */
+void LCD_moveCursor(uint8 row, uint8 col)
+{
 	/* Move the LCD cursor to this specific address */
-	LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION); /*1000 0000 | memory address*/
+	LCD_sendCommand(LCD_cursorAddress(row, col) | LCD_SET_CURSOR_LOCATION); /*1000 0000 | memory address*/
 }
 
 /*
@@ -228,15 +211,23 @@ void LCD_displayStringRowColumn(uint8 row, uint8 col, const uint8* string)
 }
 
 
+/*
+ * Description:
+ * Same as LCD_displayStringRowColumn() for a string saved in flash (PROGMEM).
+ */
+void LCD_displayStringRowColumn_P(uint8 row, uint8 col, const uint8* string)
+{
+	LCD_moveCursor(row, col);  	 /* Go to the required LCD position */
+	LCD_displayString_P(string); /* Display the string */
+}
+
 /*
  * Description:
  * This function convert integer number into ASSCI to present the value on the LCD.
  */
 void LCD_intgerToString(int intiger)
 {
-	   uint8 buff[16]; /* String to hold the ASCII result */
-	   itoa(intiger,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-	   LCD_displayString(buff); /* Display the string */
+	FORMAT_signed(LCD_displayCharacter, intiger, 0, FORMAT_PAD_SPACE); /* Send the digits directly to the LCD without a string buffer */
 }
 
 /*
@@ -248,3 +239,299 @@ void LCD_clearScreen(void)
 	LCD_sendCommand(LCD_CLEAR_SCREEN ); /* Clear Screen */
 }
 
+/*
+ * Description:
+ * Add a command to the output queue and return without waiting for the LCD.
+ * Waits only if the queue is full.
+ */
+void LCD_queueCommand(uint8 command)
+{
+	uint8 record[2] = {LCD_QUEUE_ESCAPE, command};
+
+	/* Both bytes are added together, so the ISR never takes half a command */
+	while(RING_BUFFER_pushBlock(&g_lcdQueue, record, 2) == FALSE){}
+}
+
+/*
+ * Description:
+ * Add a character to the output queue and return without waiting for the LCD.
+ * Waits only if the queue is full.
+ */
+void LCD_queueCharacter(uint8 character)
+{
+	uint8 record[2] = {LCD_QUEUE_ESCAPE, LCD_QUEUE_ESCAPE};
+
+	if(character == LCD_QUEUE_ESCAPE)
+	{
+		while(RING_BUFFER_pushBlock(&g_lcdQueue, record, 2) == FALSE){}
+	}
+	else
+	{
+		while(RING_BUFFER_push(&g_lcdQueue, character) == FALSE){}
+	}
+}
+
+/*
+ * Description:
+ * Add a cursor move to the output queue.
+ */
+void LCD_queueMoveCursor(uint8 row, uint8 col)
+{
+	LCD_queueCommand(LCD_cursorAddress(row, col) | LCD_SET_CURSOR_LOCATION);
+}
+
+/*
+ * Description:
+ * Return TRUE if all queued commands and characters are sent to the LCD.
+ */
+uint8 LCD_isQueueEmpty(void)
+{
+	return RING_BUFFER_isEmpty(&g_lcdQueue);
+}
+
+/*
+ * Description:
+ * Called from the timer ISR (every 1 ms). If the LCD is ready, send it the next queued command or character.
+ * The other LCD functions must not be used while the queue is drained from the ISR.
+ */
+void LCD_queueTick(void)
+{
+	uint8 value;
+	uint8 rs = LOGIC_HIGH;
+
+	/* Nothing to send */
+	if(RING_BUFFER_isEmpty(&g_lcdQueue))
+	{
+		return;
+	}
+
+	/* Check the LCD one time only and leave the queue for the next tick if it is still busy */
+	if(g_lcdBusyFlagEnabled)
+	{
+		if(LCD_readStatus() & (1 << LCD_BUSY_FLAG_BIT))
+		{
+			/* No command takes this long, the busy flag is not connected: use the ticks as execution time from now on */
+			g_lcdQueueBusyTicks++;
+			if(g_lcdQueueBusyTicks >= LCD_QUEUE_BUSY_TICKS)
+			{
+				g_lcdBusyFlagEnabled = FALSE;
+			}
+			return;
+		}
+		g_lcdQueueBusyTicks = 0;
+	}
+	else if(g_lcdQueueWait != 0)
+	{
+		/* Without the busy flag a tick is enough for any command except clear and return home */
+		g_lcdQueueWait--;
+		return;
+	}
+
+	RING_BUFFER_pop(&g_lcdQueue, &value);
+	if(value == LCD_QUEUE_ESCAPE)
+	{
+		RING_BUFFER_pop(&g_lcdQueue, &value);
+		if(value != LCD_QUEUE_ESCAPE)
+		{
+			rs = LOGIC_LOW;
+		}
+	}
+
+	LCD_write(value, rs);
+
+	/* Clear and return home need two ticks */
+	if((rs == LOGIC_LOW) && ((value == LCD_CLEAR_SCREEN) || (value == LCD_RETURN_HOME)))
+	{
+		g_lcdQueueWait = 1;
+	}
+}
+
+/*
+ * Description:
+ * Wait until the LCD finished the last command or character.
+ * Poll the busy flag, or wait the datasheet execution time if the busy flag is not used.
+ */
+static void LCD_waitReady(void)
+{
+	uint16 timeout;
+
+	if(g_lcdBusyFlagEnabled)
+	{
+		for(timeout = LCD_BUSY_FLAG_TIMEOUT; timeout != 0; timeout--)
+		{
+			if(!(LCD_readStatus() & (1 << LCD_BUSY_FLAG_BIT)))
+			{
+				return;
+			}
+		}
+
+		/* The busy flag never cleared (R/W pin not connected), use the datasheet times from now on */
+		g_lcdBusyFlagEnabled = FALSE;
+	}
+
+	if(g_lcdLastCommandLong)
+	{
+		_delay_us(LCD_LONG_EXECUTION_TIME_US);
+	}
+	else
+	{
+		_delay_us(LCD_EXECUTION_TIME_US);
+	}
+}
+
+/*
+ * Description:
+ * Read the busy flag and address register (RS = 0, R/W = 1).
+ */
+static uint8 LCD_readStatus(void)
+{
+	uint8 status;
+
+	/* Release the data pins so the LCD can drive them */
+#if(LCD_DATA_BITS_MODE == 8)
+	GPIO_setupPortDirectionFast(LCD_DATA_PORT_ID, PORT_INPUT);
+#elif(LCD_DATA_BITS_MODE == 4)
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 0, PIN_INPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 1, PIN_INPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 2, PIN_INPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 3, PIN_INPUT);
+#endif
+
+	/* RS = 0 (instruction register) and R/W = 1 (to read value) */
+	GPIO_writePinFast(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_LOW);
+	GPIO_writePinFast(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_HIGH);
+
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH); /* Enable(E) = 1 */
+	_delay_us(LCD_ENABLE_PULSE_US);						/* Data is valid after the data delay time */
+#if(LCD_DATA_BITS_MODE == 8)
+	status = GPIO_readPortFast(LCD_DATA_PORT_ID);
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); /* Enable(E) = 0 */
+#elif(LCD_DATA_BITS_MODE == 4)
+	/* The last 4 bits come first (the busy flag is among them), then the first 4 bits */
+#ifdef LCD_LAST_PORT_PINS
+	status = GPIO_readPortFast(LCD_DATA_PORT_ID) & 0xF0;
+#else
+	status = (GPIO_readPortFast(LCD_DATA_PORT_ID) & 0x0F) << 4;
+#endif
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); /* Enable(E) = 0 */
+	_delay_us(LCD_ENABLE_PULSE_US);
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH); /* Enable(E) = 1 */
+	_delay_us(LCD_ENABLE_PULSE_US);
+#ifdef LCD_LAST_PORT_PINS
+	status |= (GPIO_readPortFast(LCD_DATA_PORT_ID) & 0xF0) >> 4;
+#else
+	status |= GPIO_readPortFast(LCD_DATA_PORT_ID) & 0x0F;
+#endif
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); /* Enable(E) = 0 */
+#endif
+
+	/* Back to writing */
+	GPIO_writePinFast(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_LOW);
+#if(LCD_DATA_BITS_MODE == 8)
+	GPIO_setupPortDirectionFast(LCD_DATA_PORT_ID, PORT_OUTPUT);
+#elif(LCD_DATA_BITS_MODE == 4)
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 0, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 1, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 2, PIN_OUTPUT);
+	GPIO_setupPinDirectionFast(LCD_DATA_PORT_ID, LCD_FIRST_DATA_PIN_ID + 3, PIN_OUTPUT);
+#endif
+
+	return status;
+}
+
+/*
+ * Description:
+ * Check the busy flag just after a Clear Display: return TRUE if it reads busy first, then ready in time.
+ */
+static uint8 LCD_checkBusyFlag(void)
+{
+	uint16 timeout;
+
+	/* Clear Display was just sent, a working busy flag must be set now */
+	if(!(LCD_readStatus() & (1 << LCD_BUSY_FLAG_BIT)))
+	{
+		return FALSE;
+	}
+
+	for(timeout = LCD_BUSY_FLAG_CHECK_US / LCD_BUSY_FLAG_POLL_US; timeout != 0; timeout--)
+	{
+		_delay_us(LCD_BUSY_FLAG_POLL_US);
+		if(!(LCD_readStatus() & (1 << LCD_BUSY_FLAG_BIT)))
+		{
+			return TRUE;
+		}
+	}
+
+	/* Always busy (pin stuck high) */
+	return FALSE;
+}
+
+/*
+ * Description:
+ * Write a command (rs = LOGIC_LOW) or a character (rs = LOGIC_HIGH) to the LCD without waiting for it to finish.
+ */
+static void LCD_write(uint8 value, uint8 rs)
+{
+	/* RS selects command or character and R/W = 0 (to write value) */
+	GPIO_writePinFast(LCD_RS_PORT_ID, LCD_RS_PIN_ID, rs);
+	GPIO_writePinFast(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_LOW);
+
+#if(LCD_DATA_BITS_MODE == 8)
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH); /* Enable(E) = 1 */
+	GPIO_writePortFast(LCD_DATA_PORT_ID, value);				/* Send the value */
+	_delay_us(LCD_ENABLE_PULSE_US);
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); 	/* Enable(E) = 0, the LCD takes the value on this edge */
+#elif(LCD_DATA_BITS_MODE == 4)
+	LCD_writeNibble(value >> 4);							/* out the last 4 bits of the value to the data bus D4 --> D7 */
+	LCD_writeNibble(value & 0x0F);							/* out the first 4 bits of the value to the data bus D4 --> D7 */
+#endif
+}
+
+#if(LCD_DATA_BITS_MODE == 4)
+/*
+ * Description:
+ * Put 4 bits on the data pins D4 --> D7 and pulse the enable pin.
+ */
+static void LCD_writeNibble(uint8 nibble)
+{
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH); /* Enable(E) = 1 */
+
+	/* Only the 4 data pins change, the other 4 pins of the port are kept even if an ISR writes them */
+#ifdef LCD_LAST_PORT_PINS
+	GPIO_writeMaskedFast(LCD_DATA_PORT_ID, 0xF0, nibble << 4);
+#else
+	GPIO_writeMaskedFast(LCD_DATA_PORT_ID, 0x0F, nibble);
+#endif
+
+	_delay_us(LCD_ENABLE_PULSE_US);
+	GPIO_writePinFast(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW); /* Enable(E) = 0, the LCD takes the 4 bits on this edge */
+	_delay_us(LCD_ENABLE_PULSE_US);
+}
+#endif
+
+/*
+ * Description:
+ * Return the DDRAM address of a row and column.
+ */
+static uint8 LCD_cursorAddress(uint8 row, uint8 col)
+{
+	uint8 lcd_memory_address = col;
+
+	/* Calculate the required address in the LCD DDRAM */
+	switch(row)
+	{
+		case 0:
+			lcd_memory_address=col;
+				break;
+		case 1:
+			lcd_memory_address=col+0x40;
+				break;
+		case 2:
+			lcd_memory_address=col+0x10;
+				break;
+		case 3:
+			lcd_memory_address=col+0x50;
+				break;
+	}
+	return lcd_memory_address;
+}
@@ -58,6 +58,23 @@
 #define LCD_DATA_PORT_ID				PORTC_ID
 
 
+/*
+ * LCD timings. The init checks the busy flag once: it must read busy just after Clear Display and
+ * clear before LCD_BUSY_FLAG_CHECK_US. Only then is it polled, otherwise (R/W pin grounded or data
+ * pins floating) the execution times are used for every command.
+ */
+#define LCD_POWER_ON_DELAY_MS			20			/* Time for the LCD to start after power on. */
+#define LCD_ENABLE_PULSE_US				1			/* Enable pulse width, the datasheet needs 230 ns at least. */
+#define LCD_EXECUTION_TIME_US			50			/* Most commands and characters take 37 us. */
+#define LCD_LONG_EXECUTION_TIME_US		1700		/* Clear and return home take 1.52 ms. */
+#define LCD_BUSY_FLAG_TIMEOUT			500			/* Number of busy flag reads before using the execution times instead. */
+#define LCD_BUSY_FLAG_CHECK_US			4000		/* Longest time Clear Display may keep the busy flag set during the check. */
+#define LCD_BUSY_FLAG_POLL_US			10			/* Time between two busy flag reads during the check. */
+#define LCD_BUSY_FLAG_BIT				7
+
+/* Output queue drained by LCD_queueTick(), one command or character for each tick (power of two) */
+#define LCD_QUEUE_SIZE					64
+
 /* LCD Common commands */
 #define LCD_CLEAR_SCREEN 				0x01
 #define LCD_RETURN_HOME					0x02
@@ -95,6 +112,12 @@ void LCD_displayCharacter(uint8 character);
  */
 void LCD_displayString(const uint8* string);
 
+/*
+ * Description:
+ * Same as LCD_displayString() for a string saved in flash (PROGMEM).
+ */
+void LCD_displayString_P(const uint8* string);
+
 /*
  * Description:
  * This function move the cursor in memory to choose position on LCD to start with.
@@ -107,6 +130,12 @@ void LCD_moveCursor(uint8 row, uint8 col);
  */
 
 void LCD_displayStringRowColumn(uint8 row, uint8 col, const uint8* string);
+
+/*
+ * Description:
+ * Same as LCD_displayStringRowColumn() for a string saved in flash (PROGMEM).
+ */
+void LCD_displayStringRowColumn_P(uint8 row, uint8 col, const uint8* string);
 /*
  * Description:
  * This function convert integer number into ASSCI to present the value on the LCD.
@@ -119,6 +148,39 @@ void LCD_intgerToString(int intiger);
  */
 void LCD_clearScreen(void);
 
+/*
+ * Description:
+ * Add a command to the output queue and return without waiting for the LCD.
+ * Waits only if the queue is full.
+ */
+void LCD_queueCommand(uint8 command);
+
+/*
+ * Description:
+ * Add a character to the output queue and return without waiting for the LCD.
+ * Waits only if the queue is full.
+ */
+void LCD_queueCharacter(uint8 character);
+
+/*
+ * Description:
+ * Add a cursor move to the output queue.
+ */
+void LCD_queueMoveCursor(uint8 row, uint8 col);
+
+/*
+ * Description:
+ * Return TRUE if all queued commands and characters are sent to the LCD.
+ */
+uint8 LCD_isQueueEmpty(void);
+
+/*
+ * Description:
+ * Called from the timer ISR (every 1 ms). If the LCD is ready, send it the next queued command or character.
+ * The other LCD functions must not be used while the queue is drained from the ISR.
+ */
+void LCD_queueTick(void);
+
 
 
 #endif /* LCD_H_ */
@@ -0,0 +1,183 @@
+/****************************************************************************************
+ *
+ * Module: LCD Framebuffer
+ *
+ * File Name: lcd_framebuffer.c
+ *
+ * Discretion: Source file for the LCD framebuffer
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                      		Include Header	                               *
+ *******************************************************************************/
+#include "lcd_framebuffer.h"
+#include "lcd.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_framebuffer[FRAMEBUFFER_ROWS][FRAMEBUFFER_COLUMNS];		/* The screen written by the application. */
+static uint8 g_framebufferLcd[FRAMEBUFFER_ROWS][FRAMEBUFFER_COLUMNS];	/* The screen presented now on the LCD. */
+static uint8 g_framebufferRow = 0;										/* Cursor of the application. */
+static uint8 g_framebufferColumn = 0;
+static uint8 g_framebufferChanged = FALSE;								/* TRUE if the application wrote anything since the last flush. */
+
+/*******************************************************************************
+ *                      	Function Definitions                               *
+ *******************************************************************************/
+/*
+ * Description:
+ * Empty the framebuffer. Must be called after LCD_init() because both assume the LCD screen is clear.
+ */
+void FRAMEBUFFER_init(void)
+{
+	uint8 row, col;
+
+	for(row = 0; row < FRAMEBUFFER_ROWS; row++)
+	{
+		for(col = 0; col < FRAMEBUFFER_COLUMNS; col++)
+		{
+			g_framebufferLcd[row][col] = FRAMEBUFFER_BLANK;
+		}
+	}
+	FRAMEBUFFER_clear();
+}
+
+/*
+ * Description:
+ * Empty the framebuffer and move its cursor to the first cell. Nothing is sent to the LCD.
+ */
+void FRAMEBUFFER_clear(void)
+{
+	uint8 row, col;
+
+	for(row = 0; row < FRAMEBUFFER_ROWS; row++)
+	{
+		for(col = 0; col < FRAMEBUFFER_COLUMNS; col++)
+		{
+			g_framebuffer[row][col] = FRAMEBUFFER_BLANK;
+		}
+	}
+	g_framebufferRow = 0;
+	g_framebufferColumn = 0;
+	g_framebufferChanged = TRUE;
+}
+
+/*
+ * Description:
+ * Move the framebuffer cursor, the next characters are written from this cell.
+ */
+void FRAMEBUFFER_moveCursor(uint8 row, uint8 col)
+{
+	g_framebufferRow = row;
+	g_framebufferColumn = col;
+}
+
+/*
+ * Description:
+ * Write one character at the cursor and move the cursor to the next cell.
+ * Characters after the end of the row are dropped.
+ */
+void FRAMEBUFFER_displayCharacter(uint8 character)
+{
+	if((g_framebufferRow < FRAMEBUFFER_ROWS) && (g_framebufferColumn < FRAMEBUFFER_COLUMNS))
+	{
+		g_framebuffer[g_framebufferRow][g_framebufferColumn] = character;
+		g_framebufferChanged = TRUE;
+	}
+	g_framebufferColumn++;
+}
+
+/*
+ * Description:
+ * Write a string from the cursor.
+ */
+void FRAMEBUFFER_displayString(const uint8 *string)
+{
+	while(*string != '\0')
+	{
+		FRAMEBUFFER_displayCharacter(*string);
+		string++;
+	}
+}
+
+/*
+ * Description:
+ * Move the cursor and write a string from there.
+ */
+void FRAMEBUFFER_displayStringRowColumn(uint8 row, uint8 col, const uint8 *string)
+{
+	FRAMEBUFFER_moveCursor(row, col);
+	FRAMEBUFFER_displayString(string);
+}
+
+/*
+ * Description:
+ * Write a string saved in flash (PROGMEM) from the cursor.
+ */
+void FRAMEBUFFER_displayString_P(const uint8 *string)
+{
+	uint8 character = pgm_read_byte(string);
+
+	while(character != '\0')
+	{
+		FRAMEBUFFER_displayCharacter(character);
+		string++;
+		character = pgm_read_byte(string);
+	}
+}
+
+/*
+ * Description:
+ * Move the cursor and write a string saved in flash (PROGMEM) from there.
+ */
+void FRAMEBUFFER_displayStringRowColumn_P(uint8 row, uint8 col, const uint8 *string)
+{
+	FRAMEBUFFER_moveCursor(row, col);
+	FRAMEBUFFER_displayString_P(string);
+}
+
+/*
+ * Description:
+ * Send to the LCD only the cells that differ from what it presents.
+ * The cursor is moved only before the first cell of each group of changed cells.
+ * The cells are added to the LCD output queue, so this function does not wait for the LCD.
+ */
+void FRAMEBUFFER_flush(void)
+{
+	uint8 row, col;
+	uint8 lcdCursorValid;									/* TRUE if the LCD cursor is already on the current cell. */
+
+	/* Nothing is written since the last flush */
+	if(g_framebufferChanged == FALSE)
+	{
+		return;
+	}
+	g_framebufferChanged = FALSE;
+
+	for(row = 0; row < FRAMEBUFFER_ROWS; row++)
+	{
+		lcdCursorValid = FALSE;
+		for(col = 0; col < FRAMEBUFFER_COLUMNS; col++)
+		{
+			if(g_framebuffer[row][col] == g_framebufferLcd[row][col])
+			{
+				lcdCursorValid = FALSE;
+				continue;
+			}
+
+			/* The LCD moves its cursor by itself after each character, so the next changed cells need no cursor command */
+			if(lcdCursorValid == FALSE)
+			{
+				LCD_queueMoveCursor(row, col);
+				lcdCursorValid = TRUE;
+			}
+			LCD_queueCharacter(g_framebuffer[row][col]);
+			g_framebufferLcd[row][col] = g_framebuffer[row][col];
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/****************************************************************************************
+ *
+ * Module: LCD Framebuffer
+ *
+ * File Name: lcd_framebuffer.h
+ *
+ * Discretion: Header file for the LCD framebuffer. The application writes the screen in RAM
+ * 			   and the flush sends only the characters that changed to the LCD.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef LCD_FRAMEBUFFER_H_
+#define LCD_FRAMEBUFFER_H_
+
+/*******************************************************************************
+ *                      		Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      		Definitions 	                               *
+ *******************************************************************************/
+/* LCD size */
+#define FRAMEBUFFER_ROWS				2
+#define FRAMEBUFFER_COLUMNS				16
+
+/* Character of an empty cell */
+#define FRAMEBUFFER_BLANK				' '
+
+/*******************************************************************************
+ *                 	 	    Functions Prototypes                               *
+ *******************************************************************************/
+/*
+ * Description:
+ * Empty the framebuffer. Must be called after LCD_init() because both assume the LCD screen is clear.
+ */
+void FRAMEBUFFER_init(void);
+
+/*
+ * Description:
+ * Empty the framebuffer and move its cursor to the first cell. Nothing is sent to the LCD.
+ */
+void FRAMEBUFFER_clear(void);
+
+/*
+ * Description:
+ * Move the framebuffer cursor, the next characters are written from this cell.
+ */
+void FRAMEBUFFER_moveCursor(uint8 row, uint8 col);
+
+/*
+ * Description:
+ * Write one character at the cursor and move the cursor to the next cell.
+ * Characters after the end of the row are dropped.
+ */
+void FRAMEBUFFER_displayCharacter(uint8 character);
+
+/*
+ * Description:
+ * Write a string from the cursor.
+ */
+void FRAMEBUFFER_displayString(const uint8 *string);
+
+/*
+ * Description:
+ * Move the cursor and write a string from there.
+ */
+void FRAMEBUFFER_displayStringRowColumn(uint8 row, uint8 col, const uint8 *string);
+
+/*
+ * Description:
+ * Write a string saved in flash (PROGMEM) from the cursor.
+ */
+void FRAMEBUFFER_displayString_P(const uint8 *string);
+
+/*
+ * Description:
+ * Move the cursor and write a string saved in flash (PROGMEM) from there.
+ */
+void FRAMEBUFFER_displayStringRowColumn_P(uint8 row, uint8 col, const uint8 *string);
+
+/*
+ * Description:
+ * Send to the LCD only the cells that differ from what it presents.
+ * The cursor is moved only before the first cell of each group of changed cells.
+ * The cells are added to the LCD output queue, so this function does not wait for the LCD.
+ */
+void FRAMEBUFFER_flush(void);
+
+#endif /* LCD_FRAMEBUFFER_H_ */
@@ -0,0 +1,232 @@
+/****************************************************************************************
+ *
+ * Module: Ring Buffer
+ *
+ * File Name: ring_buffer.h
+ *
+ * Discretion: Single producer / single consumer byte queue to pass data from an ISR to
+ * 			   the main loop (or from the main loop to an ISR) without disabling interrupts.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*
+ * Stop the compiler from moving the buffer read/write across the index update.
+ * The AVR core itself executes the instructions in order, so no hardware barrier is needed.
+ */
+#define RING_BUFFER_BARRIER()		__asm__ __volatile__("" ::: "memory")
+
+/*
+ * With TRUE, RING_BUFFER_benchmark() measures a push and a pop with Timer1 at start-up.
+ * The result is read with the debugger, it is not needed by the application.
+ */
+#define RING_BUFFER_BENCHMARK		FALSE
+#define RING_BUFFER_BENCHMARK_LOOPS	64			/* Push and pop pairs measured together. */
+
+#if (RING_BUFFER_BENCHMARK == TRUE)
+#include <avr/io.h>
+#endif
+
+/*
+ * Description:
+ * Define a ring buffer with its own storage array, private to the file that defines it.
+ * The size must be a power of two from 2 to 128, it is checked at compile time.
+ */
+#define RING_BUFFER_DEFINE(name, size)																\
+	typedef char name##_sizeCheck[((((size) & ((size) - 1)) == 0) && ((size) >= 2) && ((size) <= 128)) ? 1 : -1];	\
+	static uint8 name##_storage[(size)];															\
+	static RING_BUFFER_Type name = {name##_storage, (size) - 1, 0, 0}
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*
+ * The head is only written by the producer and the tail is only written by the consumer.
+ * Both are one byte, so reading or writing them is one instruction and needs no critical section.
+ * They count freely from 0 to 255 and the mask selects the place in the buffer.
+ */
+typedef struct{
+	uint8 *buffer;
+	uint8 mask;
+	volatile uint8 head;
+	volatile uint8 tail;
+}RING_BUFFER_Type;
+
+#if (RING_BUFFER_BENCHMARK == TRUE)
+/* CPU cycles measured by RING_BUFFER_benchmark() */
+typedef struct{
+	uint16 loopCycles;					/* RING_BUFFER_BENCHMARK_LOOPS pairs of push then pop, with the loop itself. */
+	uint16 pairCycles;					/* One push and one pop (loopCycles / RING_BUFFER_BENCHMARK_LOOPS). */
+}RING_BUFFER_BenchmarkType;
+#endif
+
+/*******************************************************************************
+ *                         	Function Definitions                               *
+ *******************************************************************************/
+/*
+ * Description:
+ * Return the number of bytes waiting in the buffer.
+ */
+static inline uint8 RING_BUFFER_count(const RING_BUFFER_Type *a_ring_ptr)
+{
+	return (uint8)(a_ring_ptr->head - a_ring_ptr->tail);
+}
+
+/*
+ * Description:
+ * Return TRUE if no bytes are waiting in the buffer.
+ */
+static inline uint8 RING_BUFFER_isEmpty(const RING_BUFFER_Type *a_ring_ptr)
+{
+	return (a_ring_ptr->head == a_ring_ptr->tail);
+}
+
+/*
+ * Description:
+ * Producer side: add one byte to the buffer.
+ * Return FALSE without changing anything if the buffer is full.
+ */
+static inline uint8 RING_BUFFER_push(RING_BUFFER_Type *a_ring_ptr, uint8 data)
+{
+	uint8 head = a_ring_ptr->head;
+
+	if((uint8)(head - a_ring_ptr->tail) > a_ring_ptr->mask)
+	{
+		return FALSE;
+	}
+
+	a_ring_ptr->buffer[head & a_ring_ptr->mask] = data;
+	RING_BUFFER_BARRIER();				/* The byte must be in the buffer before the consumer can see it. */
+	a_ring_ptr->head = head + 1;
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Consumer side: take the oldest byte from the buffer.
+ * Return FALSE without changing anything if the buffer is empty.
+ */
+static inline uint8 RING_BUFFER_pop(RING_BUFFER_Type *a_ring_ptr, uint8 *a_data_ptr)
+{
+	uint8 tail = a_ring_ptr->tail;
+
+	if(tail == a_ring_ptr->head)
+	{
+		return FALSE;
+	}
+
+	*a_data_ptr = a_ring_ptr->buffer[tail & a_ring_ptr->mask];
+	RING_BUFFER_BARRIER();				/* The byte must be read before the producer can write over it. */
+	a_ring_ptr->tail = tail + 1;
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Producer side: add a group of bytes that the consumer will see all together or not at all.
+ * Return FALSE without changing anything if there is no place for all of them.
+ */
+static inline uint8 RING_BUFFER_pushBlock(RING_BUFFER_Type *a_ring_ptr, const uint8 *a_data_ptr, uint8 length)
+{
+	uint8 head = a_ring_ptr->head;
+	uint8 i;
+
+	if((uint8)(a_ring_ptr->mask + 1 - (uint8)(head - a_ring_ptr->tail)) < length)
+	{
+		return FALSE;
+	}
+
+	for(i = 0; i < length; i++)
+	{
+		a_ring_ptr->buffer[(uint8)(head + i) & a_ring_ptr->mask] = a_data_ptr[i];
+	}
+	RING_BUFFER_BARRIER();
+	a_ring_ptr->head = head + length;
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Consumer side: take a group of bytes added by RING_BUFFER_pushBlock().
+ * Return FALSE without changing anything if less bytes are waiting.
+ */
+static inline uint8 RING_BUFFER_popBlock(RING_BUFFER_Type *a_ring_ptr, uint8 *a_data_ptr, uint8 length)
+{
+	uint8 tail = a_ring_ptr->tail;
+	uint8 i;
+
+	if((uint8)(a_ring_ptr->head - tail) < length)
+	{
+		return FALSE;
+	}
+
+	for(i = 0; i < length; i++)
+	{
+		a_data_ptr[i] = a_ring_ptr->buffer[(uint8)(tail + i) & a_ring_ptr->mask];
+	}
+	RING_BUFFER_BARRIER();
+	a_ring_ptr->tail = tail + length;
+
+	return TRUE;
+}
+
+#if (RING_BUFFER_BENCHMARK == TRUE)
+/*
+ * Description:
+ * Measure a push and a pop on a_ring_ptr in CPU cycles with Timer1 running at F_CPU. Pass a ring made by
+ * RING_BUFFER_DEFINE at file scope, so the code is the same as the one of the drivers (constant address and mask).
+ * The result is a lower bound of a driver queue: the save and restore of the registers by its ISR is not counted.
+ * The interrupts are disabled during the measure and the Timer1 configuration is restored after,
+ * so it must be called at start-up before any Timer1 output is used.
+ */
+static inline void RING_BUFFER_benchmark(RING_BUFFER_Type *a_ring_ptr, RING_BUFFER_BenchmarkType *a_result_ptr)
+{
+	uint8 oldSREG = SREG;
+	uint8 oldTCCR1A = TCCR1A;
+	uint8 oldTCCR1B = TCCR1B;
+	uint16 overhead;
+	uint8 data;
+	uint8 i;
+
+	SREG &= ~(1<<7);					/* No ISR adds its cycles to the measure. */
+
+	/* Normal mode, no prescaler: one count each cycle, 65536 cycles before overflow. */
+	TCCR1A = 0;
+	TCCR1B = (1<<CS10);
+
+	/* Cycles of starting and reading the timer, removed from the result. */
+	TCNT1 = 0;
+	overhead = TCNT1;
+
+	TCNT1 = 0;
+	for(i = 0; i < RING_BUFFER_BENCHMARK_LOOPS; i++)
+	{
+		RING_BUFFER_push(a_ring_ptr, i);
+		RING_BUFFER_pop(a_ring_ptr, &data);
+	}
+	a_result_ptr->loopCycles = TCNT1 - overhead;
+	a_result_ptr->pairCycles = a_result_ptr->loopCycles / RING_BUFFER_BENCHMARK_LOOPS;
+
+	TCNT1 = 0;
+	TCCR1A = oldTCCR1A;
+	TCCR1B = oldTCCR1B;
+	SREG = oldSREG;
+}
+#endif
+
+#endif /* RING_BUFFER_H_ */
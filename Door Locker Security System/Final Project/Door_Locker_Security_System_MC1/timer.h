@@ -18,6 +18,16 @@
  ******************************************************************************/
 #include "std_types.h"
 
+/******************************************************************************
+ *                                Definitions                                 *
+ ******************************************************************************/
+/*
+ * The main loop tick of MC1: Timer0 in CTC mode with F_CPU/64, one compare interrupt each 1 ms
+ * (compare value 124 at 8 MHz). All the times of MC1 are written in ms and counted directly in ticks.
+ */
+#define TIMER_TICK_PRESCALER			64UL
+#define TIMER_TICK_COMPARE_VALUE		((F_CPU / TIMER_TICK_PRESCALER / 1000UL) - 1)
+
 /******************************************************************************
  *                         	   Types Declaration                              *
  ******************************************************************************/
@@ -18,6 +18,13 @@
  *******************************************************************************/
 #include "std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* Size of the buffers used when the RX/TX interrupts are enabled (power of two), a full link frame fits in each. */
+#define UART_RX_BUFFER_SIZE				64
+#define UART_TX_BUFFER_SIZE				64
+
 /*******************************************************************************
  *                         	Types Declaration                                  *
  *******************************************************************************/
@@ -82,6 +89,8 @@ void UART_init(uint32 a_bandRate, const UART_ConfigType *config_ptr);
  * Description:
  * wait until the UDR register is empty.
  * sent 8-bits data by put the data value in UDR register.
+ * If the TX interrupt is enabled, the data is added to the transmit buffer and sent by the interrupt,
+ * the function only waits if the buffer is full.
  */
 void UART_sendByte(const uint8 data);
 
@@ -89,9 +98,17 @@ void UART_sendByte(const uint8 data);
  * Description:
  * wait until the UDR register receive all 8-bits data.
  * Return this data to be saved in another variable.
+ * If the RX interrupt is enabled, the data is taken from the receive buffer filled by the interrupt.
  */
 uint8 UART_recieveByte(void);
 
+/*
+ * Description:
+ * Check without waiting if a new byte is received in the UDR register.
+ * Return TRUE if UART_recieveByte() can read it directly, FALSE otherwise.
+ */
+uint8 UART_isDataReceived(void);
+
 /*
  * Description:
  * This function take a string in a pointer.
@@ -4,35 +4,59 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../adc.c \
 ../buzzer.c \
+../chacha20.c \
 ../dc_motor.c \
+../door.c \
 ../door_locker_security_system_mc2.c \
 ../external_eeprom.c \
 ../gpio.c \
 ../i2c.c \
+../link.c \
+../lockout.c \
+../password.c \
+../poly1305.c \
 ../pwm.c \
+../sha256.c \
 ../timer.c \
 ../uart.c 
 
 OBJS += \
+./adc.o \
 ./buzzer.o \
+./chacha20.o \
 ./dc_motor.o \
+./door.o \
 ./door_locker_security_system_mc2.o \
 ./external_eeprom.o \
 ./gpio.o \
 ./i2c.o \
+./link.o \
+./lockout.o \
+./password.o \
+./poly1305.o \
 ./pwm.o \
+./sha256.o \
 ./timer.o \
 ./uart.o 
 
 C_DEPS += \
+./adc.d \
 ./buzzer.d \
+./chacha20.d \
 ./dc_motor.d \
+./door.d \
 ./door_locker_security_system_mc2.d \
 ./external_eeprom.d \
 ./gpio.d \
 ./i2c.d \
+./link.d \
+./lockout.d \
+./password.d \
+./poly1305.d \
 ./pwm.d \
+./sha256.d \
 ./timer.d \
 ./uart.d 
 
@@ -41,7 +65,7 @@ C_DEPS += \
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -Os -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
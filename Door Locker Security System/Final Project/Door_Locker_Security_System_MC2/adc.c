@@ -0,0 +1,166 @@
+/****************************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.c
+ *
+ * Discretion: Source file for the AVR ADC driver
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "adc.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "common_macros.h"
+#include "gpio.h"
+#include "sync.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Global variables to hold the address of the call back function in the application */
+static void (*volatile g_adcCallBackPtr)(uint8 channel, uint16 average) = NULL_PTR;
+
+static volatile uint16 g_adcFilter[ADC_NUMBER_OF_CHANNELS];		/* Average of each channel multiplied by 2^ADC_FILTER_SHIFT. */
+static volatile uint8 g_adcChannels = 0;						/* Channels to convert, bit n is ADCn. */
+static volatile uint8 g_adcChannel = 0;							/* Channel of the conversion that is running. */
+static volatile uint8 g_adcRunning = FALSE;						/* FALSE stops the chain of conversions. */
+
+/*******************************************************************************
+ *                      	Function Prototypes                                *
+ *******************************************************************************/
+static uint8 ADC_nextChannel(uint8 channel);
+
+/*******************************************************************************
+ *                         	Function Definitions                               *
+ *******************************************************************************/
+/*
+ * Description:
+ * Enable the ADC with the required reference and clock. No conversion is started.
+ */
+void ADC_init(const ADC_ConfigType *config_ptr)
+{
+	/* REFS1:0 = reference, ADLAR = 0 (right adjusted result), MUX4:0 = ADC0 */
+	ADMUX = (config_ptr->referenceVoltage & 0x03)<<REFS0;
+
+	/* ADEN = 1 (enable), ADIE = 1 (interrupt on each conversion), ADATE = 0 (the ISR starts the next one) */
+	ADCSRA = (1<<ADEN) | (1<<ADIE) | ((config_ptr->prescaler & 0x07)<<ADPS0);
+}
+
+/*
+ * Description:
+ * Select the channels to convert, bit n of the mask is ADCn. The pins are made inputs.
+ */
+void ADC_setChannels(uint8 channelMask)
+{
+	DDRA &= ~channelMask;
+	g_adcChannels = channelMask;
+}
+
+/*
+ * Description:
+ * Reset the averages and start converting the selected channels in the background.
+ * Each conversion starts the next one from the ISR, one conversion takes 13 ADC clocks.
+ */
+void ADC_start(void)
+{
+	uint8 channel;
+	uint8 sreg;
+
+	if((g_adcChannels == 0) || g_adcRunning)
+	{
+		return;
+	}
+
+	sreg = SYNC_enterCritical();
+	for(channel = 0; channel < ADC_NUMBER_OF_CHANNELS; channel++)
+	{
+		g_adcFilter[channel] = 0;
+	}
+	g_adcChannel = ADC_nextChannel(ADC_NUMBER_OF_CHANNELS - 1);
+	ADMUX = (ADMUX & 0xE0) | g_adcChannel;
+	g_adcRunning = TRUE;
+	SET_BIT(ADCSRA, ADSC);
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Stop converting after the conversion that is running now.
+ */
+void ADC_stop(void)
+{
+	g_adcRunning = FALSE;
+}
+
+/*
+ * Description:
+ * Return the filtered value of the channel (0 to ADC_MAX_VALUE).
+ */
+uint16 ADC_getAverage(uint8 channel)
+{
+	return SYNC_readU16(&g_adcFilter[channel & (ADC_NUMBER_OF_CHANNELS - 1)]) >> ADC_FILTER_SHIFT;
+}
+
+/*
+ * Description:
+ * Call the function from the ADC ISR after each conversion with the channel and its new filtered value.
+ */
+void ADC_setCallBack(void(*a_ptr)(uint8 channel, uint16 average))
+{
+	/* Save the address of the Call back function in a global variable (two bytes, the ISR must not read half of it) */
+	uint8 sreg = SYNC_enterCritical();
+	g_adcCallBackPtr = a_ptr;
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Return the next selected channel after the given one (the same one if it is the only selected channel).
+ */
+static uint8 ADC_nextChannel(uint8 channel)
+{
+	uint8 i;
+
+	for(i = 0; i < ADC_NUMBER_OF_CHANNELS; i++)
+	{
+		channel = (channel + 1) & (ADC_NUMBER_OF_CHANNELS - 1);
+		if(BIT_IS_SET(g_adcChannels, channel))
+		{
+			break;
+		}
+	}
+	return channel;
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(ADC_vect)
+{
+	uint8 channel = g_adcChannel;
+	uint16 filter = g_adcFilter[channel];
+	void (*callBack)(uint8 channel, uint16 average) = g_adcCallBackPtr;
+
+	/* Moving average in fixed point: filter = filter - filter / 2^n + sample */
+	filter = filter - (filter >> ADC_FILTER_SHIFT) + ADC;
+	g_adcFilter[channel] = filter;
+
+	/* Start the next channel before calling the application, so the ADC is not waiting for it */
+	if(g_adcRunning)
+	{
+		g_adcChannel = ADC_nextChannel(channel);
+		ADMUX = (ADMUX & 0xE0) | g_adcChannel;
+		SET_BIT(ADCSRA, ADSC);
+	}
+
+	if(callBack != NULL_PTR)
+	{
+		(*callBack)(channel, filter >> ADC_FILTER_SHIFT);
+	}
+}
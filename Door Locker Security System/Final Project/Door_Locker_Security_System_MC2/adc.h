@@ -0,0 +1,92 @@
+/****************************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.h
+ *
+ * Discretion: Header file for the AVR ADC driver. The enabled channels are converted one after
+ * 			   the other from the ADC interrupt and each one is filtered by a moving average.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef ADC_H_
+#define ADC_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define ADC_NUMBER_OF_CHANNELS			8			/* ADC0 --> ADC7 on PA0 --> PA7. */
+#define ADC_MAX_VALUE					1023		/* 10-bit result. */
+
+/*
+ * Each channel is filtered by an exponential moving average in fixed point:
+ * average = average + (sample - average) / 2^ADC_FILTER_SHIFT.
+ * The sum is kept multiplied by 2^ADC_FILTER_SHIFT, so no fraction is lost and no division is needed.
+ * 1023 * 2^4 fits in 16 bits.
+ */
+#define ADC_FILTER_SHIFT				4
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum{
+	ADC_AREF, ADC_AVCC, ADC_INTERNAL_2_56V = 3
+}ADC_ReferenceVoltage;
+
+typedef enum{
+	ADC_F_CPU_2 = 1, ADC_F_CPU_4, ADC_F_CPU_8, ADC_F_CPU_16, ADC_F_CPU_32, ADC_F_CPU_64, ADC_F_CPU_128
+}ADC_Prescaler;
+
+typedef struct{
+	ADC_ReferenceVoltage referenceVoltage;
+	ADC_Prescaler prescaler;			/* The ADC clock must be 50 kHz --> 200 kHz for the full 10-bit resolution. */
+}ADC_ConfigType;
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Enable the ADC with the required reference and clock. No conversion is started.
+ */
+void ADC_init(const ADC_ConfigType *config_ptr);
+
+/*
+ * Description:
+ * Select the channels to convert, bit n of the mask is ADCn. The pins are made inputs.
+ */
+void ADC_setChannels(uint8 channelMask);
+
+/*
+ * Description:
+ * Reset the averages and start converting the selected channels in the background.
+ * Each conversion starts the next one from the ISR, one conversion takes 13 ADC clocks.
+ */
+void ADC_start(void);
+
+/*
+ * Description:
+ * Stop converting after the conversion that is running now.
+ */
+void ADC_stop(void);
+
+/*
+ * Description:
+ * Return the filtered value of the channel (0 to ADC_MAX_VALUE).
+ */
+uint16 ADC_getAverage(uint8 channel);
+
+/*
+ * Description:
+ * Call the function from the ADC ISR after each conversion with the channel and its new filtered value.
+ */
+void ADC_setCallBack(void(*a_ptr)(uint8 channel, uint16 average));
+
+#endif /* ADC_H_ */
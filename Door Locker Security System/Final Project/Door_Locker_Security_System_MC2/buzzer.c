@@ -14,35 +14,150 @@
  *                    	     	Include Header	                               *
  *******************************************************************************/
 #include "buzzer.h"
-#include "gpio.h"
+#include "pwm.h"
+#include "timer.h"
+#include <avr/pgmspace.h>
+
+/******************************************************************************
+ *									 Definitions							  *
+ ******************************************************************************/
+#define BUZZER_COUNT_OF(array)		(sizeof(array) / sizeof((array)[0]))
 
 /*******************************************************************************
- *                         	Function Deceleration                              *
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* One part of a pattern: the loudness for a number of ticks */
+typedef struct
+{
+	uint8 ticks;
+	uint8 volume;
+}BUZZER_StepType;
+
+typedef struct
+{
+	const BUZZER_StepType *steps;			/* Steps in flash. */
+	uint8 count;							/* Number of steps. */
+	uint8 repeat;							/* TRUE to start again after the last step. */
+}BUZZER_PatternConfigType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
  *******************************************************************************/
+static const BUZZER_StepType g_alarmSteps[] PROGMEM 	= {{TIMER_MS_TO_TICKS(500), BUZZER_VOLUME_HIGH}, {TIMER_MS_TO_TICKS(250), BUZZER_VOLUME_OFF}};
+static const BUZZER_StepType g_keyClickSteps[] PROGMEM 	= {{1, BUZZER_VOLUME_LOW}};
+static const BUZZER_StepType g_successSteps[] PROGMEM 	= {{TIMER_MS_TO_TICKS(125), BUZZER_VOLUME_HIGH}, {TIMER_MS_TO_TICKS(65), BUZZER_VOLUME_OFF}, {TIMER_MS_TO_TICKS(125), BUZZER_VOLUME_HIGH}};
+static const BUZZER_StepType g_errorSteps[] PROGMEM 	= {{TIMER_MS_TO_TICKS(500), BUZZER_VOLUME_HIGH}};
+
+/* Patterns indexed by BUZZER_PatternType */
+static const BUZZER_PatternConfigType g_patterns[] PROGMEM =
+{
+	{g_alarmSteps, BUZZER_COUNT_OF(g_alarmSteps), TRUE},
+	{g_keyClickSteps, BUZZER_COUNT_OF(g_keyClickSteps), FALSE},
+	{g_successSteps, BUZZER_COUNT_OF(g_successSteps), FALSE},
+	{g_errorSteps, BUZZER_COUNT_OF(g_errorSteps), FALSE}
+};
 
+static const BUZZER_PatternConfigType *g_buzzerPattern = NULL_PTR;	/* Pattern playing now, NULL_PTR if muted. */
+static uint8 g_buzzerStep = 0;										/* Step of the pattern playing now. */
+static uint8 g_buzzerTicks = 0;										/* Ticks left in the step. */
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
 /*
  * Description:
- * Activate the Buzzer pin as output bin.
+ * Start a step of the pattern playing now.
+ */
+static void BUZZER_startStep(uint8 step);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Start the tone output on OC1A with the buzzer muted.
  */
 void BUZZER_init(void)
 {
-	GPIO_setupPinDirection(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT); /* Activate buzzer pin */
+	PWM_init(PWM_CHANNEL_OC1A, PWM_F_CPU_8);
+	BUZZER_stop();
+}
+
+/*
+ * Description:
+ * Start playing a pattern in the background, the function returns immediately.
+ * The new pattern replaces the old one, except a repeated pattern (the alarm) that only BUZZER_stop() ends.
+ */
+void BUZZER_play(BUZZER_PatternType pattern)
+{
+	if(pattern >= BUZZER_COUNT_OF(g_patterns))
+	{
+		return;
+	}
+	if((g_buzzerPattern != NULL_PTR) && pgm_read_byte(&g_buzzerPattern->repeat))
+	{
+		return;
+	}
+
+	g_buzzerPattern = &g_patterns[pattern];
+	BUZZER_startStep(0);
+}
+
+/*
+ * Description:
+ * Stop the pattern and mute the buzzer.
+ */
+void BUZZER_stop(void)
+{
+	g_buzzerPattern = NULL_PTR;
+	g_buzzerTicks = 0;
+	PWM_setCompare(PWM_CHANNEL_OC1A, BUZZER_VOLUME_OFF);
 }
 
 /*
  * Description:
- * Make the buzzer produce sound.
+ * Play the next part of the pattern. Must be called from the main loop for every timer tick.
  */
-void BUZZER_on(void)
+void BUZZER_tick(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH); /* buzzer is on when the output is logically high */
+	uint8 step;
+
+	if(g_buzzerPattern == NULL_PTR)
+	{
+		return;
+	}
+
+	if(g_buzzerTicks > 1)
+	{
+		g_buzzerTicks--;
+		return;
+	}
+
+	/* The step is finished, go to the next one, or to the first one of a repeated pattern. */
+	step = g_buzzerStep + 1;
+	if(step < pgm_read_byte(&g_buzzerPattern->count))
+	{
+		BUZZER_startStep(step);
+	}
+	else if(pgm_read_byte(&g_buzzerPattern->repeat))
+	{
+		BUZZER_startStep(0);
+	}
+	else
+	{
+		BUZZER_stop();
+	}
 }
 
 /*
  * Description:
- * Mute the buzzer.
+ * Start a step of the pattern playing now.
  */
-void BUZZER_off(void)
+static void BUZZER_startStep(uint8 step)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW); /* buzzer is off when the output is logically low */
+	const BUZZER_StepType *step_ptr = (const BUZZER_StepType *)pgm_read_ptr(&g_buzzerPattern->steps) + step;
+
+	g_buzzerStep = step;
+	g_buzzerTicks = pgm_read_byte(&step_ptr->ticks);
+	PWM_setCompare(PWM_CHANNEL_OC1A, pgm_read_byte(&step_ptr->volume));
 }
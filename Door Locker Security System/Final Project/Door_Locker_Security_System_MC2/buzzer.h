@@ -21,28 +21,52 @@
 /******************************************************************************
  *									 Definitions							  *
  ******************************************************************************/
-#define BUZZER_PORT_ID		PORTC_ID
-#define BUZZER_PIN_ID		PIN7_ID
+/*
+ * The buzzer is on OC1A (PD5). The tone is the Timer1 PWM output (8 MHz / (8 * 256) = 3.9 kHz, near the
+ * resonance of the piezo buzzers), so the CPU does not toggle the pin. The duty cycle sets the loudness.
+ */
+#define BUZZER_VOLUME_OFF		0
+#define BUZZER_VOLUME_LOW		16			/* 6% duty cycle, short and quiet pulses. */
+#define BUZZER_VOLUME_HIGH		128			/* 50% duty cycle, the loudest square wave. */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* Sound patterns saved in flash, the ticks are the timer ticks of the main loop (TIMER_TICKS_PER_SECOND of timer.h) */
+typedef enum
+{
+	BUZZER_ALARM,			/* 0.5 second on, 0.25 second off, repeated until BUZZER_stop(). */
+	BUZZER_KEY_CLICK,		/* One short quiet tick. */
+	BUZZER_SUCCESS,			/* Two short beeps. */
+	BUZZER_ERROR			/* One long beep. */
+}BUZZER_PatternType;
 
 /*******************************************************************************
  *                         	Function Prototypes                                *
  *******************************************************************************/
 /*
  * Description:
- * Activate the Buzzer pin as output bin.
+ * Start the tone output on OC1A with the buzzer muted.
  */
 void BUZZER_init(void);
 
 /*
  * Description:
- * Make the buzzer produce sound.
+ * Start playing a pattern in the background, the function returns immediately.
+ * The new pattern replaces the old one, except a repeated pattern (the alarm) that only BUZZER_stop() ends.
+ */
+void BUZZER_play(BUZZER_PatternType pattern);
+
+/*
+ * Description:
+ * Stop the pattern and mute the buzzer.
  */
-void BUZZER_on(void);
+void BUZZER_stop(void);
 
 /*
  * Description:
- * Mute the buzzer.
+ * Play the next part of the pattern. Must be called from the main loop for every timer tick.
  */
-void BUZZER_off(void);
+void BUZZER_tick(void);
 
 #endif /* BUZZER_H_ */
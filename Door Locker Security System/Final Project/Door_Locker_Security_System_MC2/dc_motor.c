@@ -17,54 +17,197 @@
 #include "pwm.h"
 #include <avr/io.h>
 #include "gpio.h"
+#include "sync.h"
+#include <avr/pgmspace.h>
 
 
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct
+{
+	/* Written by the application and read by the PWM ISR */
+	volatile DcMotor_State targetDirection;		/* Direction required by the application. */
+	volatile uint8 targetCompare;				/* Compare value required by the application. */
+
+	/* Written only by the PWM ISR (and by DCMotor_stopNow() with interrupts disabled) */
+	volatile DcMotor_State direction;			/* Direction of the pins now. */
+	volatile uint8 compare;						/* Compare value on the PWM now. */
+}DCMotor_Type;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Pins of each motor */
+static const DCMotor_ConfigType g_motorConfig[DC_MOTORS_COUNT] PROGMEM =
+{
+	{DC_MOTOR0_PORT_ID, DC_MOTOR0_PINA_ID, DC_MOTOR0_PINB_ID, DC_MOTOR0_PWM},
+	{DC_MOTOR1_PORT_ID, DC_MOTOR1_PINA_ID, DC_MOTOR1_PINB_ID, DC_MOTOR1_PWM}
+};
+
+static DCMotor_Type g_motors[DC_MOTORS_COUNT];				/* Speed and direction of each motor. */
+static volatile uint8 g_motorRampStep = DC_RAMP_STEP;		/* Compare value change of each ramp period. */
+static uint8 g_motorRampCounter = 0;						/* PWM periods since the last ramp step. */
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+static void DCMotor_writeDirection(uint8 motor, DcMotor_State state);
+static void DCMotor_rampTick(void);
+
 /*******************************************************************************
  *                    	    Functions Declaration                              *
  *******************************************************************************/
 /*
  * Description:
- * The Function responsible for setup the direction for the two motor pins through the GPIO driver.
- * Stop at the DC-Motor at the beginning through the GPIO driver.
+ * The Function responsible for setup the direction for the two pins of each motor through the GPIO driver.
+ * Stop all the motors at the beginning through the GPIO driver and start their PWM.
  */
 void DCMotor_init(void)
 {
-	/* Select the pins that the motor are connected with */
-	GPIO_setupPinDirection(DC_PORT_ID, DC_PINA_ID, PIN_OUTPUT);
-	GPIO_setupPinDirection(DC_PORT_ID, DC_PINB_ID, PIN_OUTPUT);
+	uint8 motor;
+	uint8 port;
 
-	/* Initial condition to stop the motor */
-	GPIO_writePin(DC_PORT_ID, DC_PINA_ID, LOGIC_LOW);
-	GPIO_writePin(DC_PORT_ID, DC_PINB_ID, LOGIC_LOW);
+	for(motor = 0; motor < DC_MOTORS_COUNT; motor++)
+	{
+		/* Select the pins that the motor are connected with */
+		port = pgm_read_byte(&g_motorConfig[motor].port);
+		GPIO_setupPinDirection(port, pgm_read_byte(&g_motorConfig[motor].pinA), PIN_OUTPUT);
+		GPIO_setupPinDirection(port, pgm_read_byte(&g_motorConfig[motor].pinB), PIN_OUTPUT);
+
+		/* Start the PWM once with the motor stopped, 8 MHz / (8 * 256) = 3.9 kHz */
+		PWM_init((PWM_ChannelType)pgm_read_byte(&g_motorConfig[motor].pwm), PWM_F_CPU_8);
+
+		/* Initial condition to stop the motor */
+		DCMotor_stopNow(motor);
+	}
+
+	/* The Timer2 overflow ISR runs the speed ramps of all the motors */
+	PWM_setOverflowCallBack(DCMotor_rampTick);
 }
 
 /*
  * Description:
  * The function responsible for rotate the DC Motor CW/ or A-CW or stop the motor based on the state input state value.
- *  Send the required duty cycle to the PWM driver based on the required speed value.
+ * The speed is reached by a trapezoidal ramp from the PWM ISR, the function returns immediately.
+ * To change the direction, the motor slows down to zero first and then speeds up in the new direction.
+ * A wrong motor number is ignored.
  */
-void DCMotor_rotate(DcMotor_State state,uint8 speed)
+void DCMotor_rotate(uint8 motor, DcMotor_State state, uint8 speed)
 {
+	uint8 sreg;
 
-	PWM_Timer2_init(speed); /* Adjust PWM according to the speed percentage the user want */
-
-	/* State of the motor */
-	if(state == STOP)
+	if(motor >= DC_MOTORS_COUNT)
 	{
-		GPIO_writePin(DC_PORT_ID, DC_PINA_ID, LOGIC_LOW);
-		GPIO_writePin(DC_PORT_ID, DC_PINB_ID, LOGIC_LOW);
+		return;
 	}
-	else if(state == CW)
+	if(speed > PWM_MAX_DUTY)
 	{
-		GPIO_writePin(DC_PORT_ID, DC_PINA_ID, LOGIC_HIGH);
-		GPIO_writePin(DC_PORT_ID, DC_PINB_ID, LOGIC_LOW);
+		speed = PWM_MAX_DUTY;
 	}
-	else if(state == CCW)
+
+	/* Both targets change together, the ISR must not see the new direction with the old speed */
+	sreg = SYNC_enterCritical();
+	g_motors[motor].targetDirection = state;
+	g_motors[motor].targetCompare = (state == STOP) ? 0 : PWM_DUTY_TO_COMPARE(speed);
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Stop the motor immediately without the ramp (for faults).
+ */
+void DCMotor_stopNow(uint8 motor)
+{
+	uint8 sreg;
+
+	if(motor >= DC_MOTORS_COUNT)
 	{
-		GPIO_writePin(DC_PORT_ID, DC_PINA_ID, LOGIC_LOW);
-		GPIO_writePin(DC_PORT_ID, DC_PINB_ID, LOGIC_HIGH);
+		return;
 	}
+
+	sreg = SYNC_enterCritical();
+	g_motors[motor].targetDirection = STOP;
+	g_motors[motor].targetCompare = 0;
+	g_motors[motor].direction = STOP;
+	g_motors[motor].compare = 0;
+	PWM_setCompare((PWM_ChannelType)pgm_read_byte(&g_motorConfig[motor].pwm), 0);
+	DCMotor_writeDirection(motor, STOP);
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Change the acceleration of all the motors: the compare value change (0 to 255 scale) of each ramp period.
+ * 0 removes the ramp and the motor jumps to the required speed.
+ */
+void DCMotor_setAcceleration(uint8 step)
+{
+	g_motorRampStep = (step == 0) ? PWM_MAX_COMPARE : step;
+}
+
+/*
+ * Description:
+ * Write the two direction pins of the motor together.
+ */
+static void DCMotor_writeDirection(uint8 motor, DcMotor_State state)
+{
+	uint8 pinA = 1 << pgm_read_byte(&g_motorConfig[motor].pinA);
+	uint8 pinB = 1 << pgm_read_byte(&g_motorConfig[motor].pinB);
+	uint8 value = (state == CW) ? pinA : ((state == CCW) ? pinB : 0);
+
+	GPIO_writeMasked(pgm_read_byte(&g_motorConfig[motor].port), pinA | pinB, value);
 }
 
+/*
+ * Description:
+ * Called by the PWM ISR each period, moves the speed of each motor one step toward its target every DC_RAMP_PERIOD periods.
+ * The direction pins change only while the speed is zero.
+ */
+static void DCMotor_rampTick(void)
+{
+	uint8 step = g_motorRampStep;
+	uint8 motor;
+	uint8 compare;
+	uint8 target;
+	DCMotor_Type *motor_ptr;
 
+	if(++g_motorRampCounter < DC_RAMP_PERIOD)
+	{
+		return;
+	}
+	g_motorRampCounter = 0;
 
+	for(motor = 0; motor < DC_MOTORS_COUNT; motor++)
+	{
+		motor_ptr = &g_motors[motor];
+		compare = motor_ptr->compare;
+
+		/* Going to another direction: slow down to zero first */
+		target = (motor_ptr->direction == motor_ptr->targetDirection) ? motor_ptr->targetCompare : 0;
+
+		if(compare < target)
+		{
+			compare = ((uint8)(target - compare) > step) ? (compare + step) : target;
+		}
+		else if(compare > target)
+		{
+			compare = ((uint8)(compare - target) > step) ? (compare - step) : target;
+		}
+		else if(motor_ptr->direction != motor_ptr->targetDirection)
+		{
+			/* Stopped, the direction can change now and the next steps speed up */
+			motor_ptr->direction = motor_ptr->targetDirection;
+			DCMotor_writeDirection(motor, motor_ptr->direction);
+			continue;
+		}
+		else
+		{
+			/* Target reached, nothing changes */
+			continue;
+		}
+
+		motor_ptr->compare = compare;
+		PWM_setCompare((PWM_ChannelType)pgm_read_byte(&g_motorConfig[motor].pwm), compare);
+	}
+}
@@ -17,14 +17,33 @@
  *                      		Include Header	                               *
  *******************************************************************************/
 #include "std_types.h"
+#include "pwm.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
-#define DC_PORT_ID 			PORTB_ID
-#define DC_PINA_ID			PIN0_ID
-#define DC_PINB_ID			PIN1_ID
-#define EN_PIN_ID			PIN3_ID
+#define DC_MOTORS_COUNT		2			/* Number of motors driven by this ECU, one for each door. */
+
+/* Motor 0: direction pins PB0, PB1 and the enable pin on OC2 (PD7) */
+#define DC_MOTOR0_PORT_ID	PORTB_ID
+#define DC_MOTOR0_PINA_ID	PIN0_ID
+#define DC_MOTOR0_PINB_ID	PIN1_ID
+#define DC_MOTOR0_PWM		PWM_CHANNEL_OC2
+
+/* Motor 1: direction pins PC2, PC3 and the enable pin on OC1B (PD4) */
+#define DC_MOTOR1_PORT_ID	PORTC_ID
+#define DC_MOTOR1_PINA_ID	PIN2_ID
+#define DC_MOTOR1_PINB_ID	PIN3_ID
+#define DC_MOTOR1_PWM		PWM_CHANNEL_OC1B
+
+/*
+ * Motion profile: the PWM compare value moves to the required speed by DC_RAMP_STEP every ramp period.
+ * The ramp period is DC_RAMP_PERIOD PWM periods (39 * 256 us = 10 ms at 3.9 kHz),
+ * so a full speed change (0 --> 255) takes 51 steps (about 0.5 second).
+ * All the motors are ramped from the Timer2 overflow ISR.
+ */
+#define DC_RAMP_PERIOD		39
+#define DC_RAMP_STEP		5
 /*******************************************************************************
  *                         Types Declaration                                   *
  *******************************************************************************/
@@ -33,21 +52,45 @@ typedef enum
 	STOP, CW, CCW
 }DcMotor_State;
 
+/* Pins of one motor */
+typedef struct
+{
+	uint8 port;					/* Port of the two direction pins. */
+	uint8 pinA;					/* High for CW. */
+	uint8 pinB;					/* High for CCW. */
+	PWM_ChannelType pwm;		/* PWM output on the enable pin of the H-bridge. */
+}DCMotor_ConfigType;
+
 /*******************************************************************************
  *                      	Function Definitions                               *
  *******************************************************************************/
 /*
  * Description:
- * The Function responsible for setup the direction for the two motor pins through the GPIO driver.
- * Stop at the DC-Motor at the beginning through the GPIO driver.
+ * The Function responsible for setup the direction for the two pins of each motor through the GPIO driver.
+ * Stop all the motors at the beginning through the GPIO driver and start their PWM.
  */
 void DCMotor_init(void);
 
 /*
  * Description:
  * The function responsible for rotate the DC Motor CW/ or A-CW or stop the motor based on the state input state value.
- *  Send the required duty cycle to the PWM driver based on the required speed value.
+ * The speed is reached by a trapezoidal ramp from the PWM ISR, the function returns immediately.
+ * To change the direction, the motor slows down to zero first and then speeds up in the new direction.
+ * A wrong motor number is ignored.
+ */
+void DCMotor_rotate(uint8 motor, DcMotor_State state, uint8 speed);
+
+/*
+ * Description:
+ * Stop the motor immediately without the ramp (for faults).
+ */
+void DCMotor_stopNow(uint8 motor);
+
+/*
+ * Description:
+ * Change the acceleration of all the motors: the compare value change (0 to 255 scale) of each ramp period.
+ * 0 removes the ramp and the motor jumps to the required speed.
  */
-void DCMotor_rotate(DcMotor_State state,uint8 speed);
+void DCMotor_setAcceleration(uint8 step);
 
 #endif /* DC_MOTOR_H_ */
@@ -0,0 +1,517 @@
+ /******************************************************************************
+ *
+ * Module: DOOR
+ *
+ * File Name: door.c
+ *
+ * Description: Source file for the door actuation state machine
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "door.h"
+#include "dc_motor.h"
+#include "adc.h"
+#include "sync.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* Time of opening or closing: the safety timeout with limit switches, the travel time without them */
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+#define DOOR_TRAVEL_TICKS					DOOR_TRAVEL_TIMEOUT_TICKS
+#else
+#define DOOR_TRAVEL_TICKS					DOOR_OPEN_CLOSE_TICKS
+#endif
+
+#if(DOOR_COUNT > DC_MOTORS_COUNT)
+#error "Each door needs its own motor, DOOR_COUNT must not be more than DC_MOTORS_COUNT"
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct
+{
+	DOOR_State state;						/* Current state of the door. */
+	uint16 ticksRemaining;					/* Number of timer ticks left in the current state. */
+	uint16 ticksElapsed;					/* Number of timer ticks spent in the current state (used to re-open while closing). */
+
+	volatile uint8 stallArmed;				/* TRUE while the motor current is checked (moving and the start is finished). */
+	uint8 stallSamples;						/* Number of current samples above the stall current one after the other (ADC ISR only). */
+	SYNC_Flag stalled;						/* Set by the ADC ISR after it stopped the stalled motor. */
+}DOOR_Type;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Motor, limit switches and current channel of each door */
+static const DOOR_ConfigType g_doorConfig[DOOR_COUNT] PROGMEM =
+{
+	{0, DOOR0_OPEN_LIMIT_PORT_ID, DOOR0_OPEN_LIMIT_PIN_ID, DOOR0_OPEN_LIMIT_LINE,
+		DOOR0_CLOSED_LIMIT_PORT_ID, DOOR0_CLOSED_LIMIT_PIN_ID, DOOR0_CLOSED_LIMIT_LINE, DOOR0_CURRENT_CHANNEL},
+	{1, DOOR1_OPEN_LIMIT_PORT_ID, DOOR1_OPEN_LIMIT_PIN_ID, DOOR1_OPEN_LIMIT_LINE,
+		DOOR1_CLOSED_LIMIT_PORT_ID, DOOR1_CLOSED_LIMIT_PIN_ID, DOOR1_CLOSED_LIMIT_LINE, DOOR1_CURRENT_CHANNEL}
+};
+
+static DOOR_Type g_doors[DOOR_COUNT];				/* State machine of each door. */
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Move the door to a new state, drive the motor for that state and load its time.
+ */
+static void DOOR_enterState(uint8 door, DOOR_State state, uint16 ticks);
+
+/*
+ * Description:
+ * Advance the state machine of one door by one timer tick.
+ */
+static void DOOR_tickDoor(uint8 door);
+
+/*
+ * Description:
+ * The opening or closing travel is finished, go to holding or idle.
+ */
+static void DOOR_travelFinished(uint8 door);
+
+/*
+ * Description:
+ * Called by the ADC ISR with each filtered motor current, stops the motor at once when it stalls.
+ */
+static void DOOR_currentSample(uint8 channel, uint16 average);
+
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+/*
+ * Description:
+ * Return TRUE if the limit switch at the end of the current travel of the door is pressed.
+ */
+static uint8 DOOR_isLimitReached(uint8 door);
+
+/*
+ * Description:
+ * Enable the pull-up of a limit switch and its interrupt if it is on an external interrupt line.
+ */
+static void DOOR_setupLimit(uint8 port, uint8 pin, uint8 line);
+#endif
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Stop the motors and put all the doors in the idle (closed) state.
+ * Enable the interrupts of the limit switches if they are used and the motor current measurement.
+ */
+void DOOR_init(void)
+{
+	/* ADC clock 8 MHz / 128 = 62.5 kHz, the motor currents are converted only while a door is moving. */
+	ADC_ConfigType ADC_config = {ADC_AVCC, ADC_F_CPU_128};
+	uint8 channels = 0;
+	uint8 door;
+
+#if(DOOR_COUNT > 1)
+	uint8 sreg, mcucsr;
+
+	/* Free PC2..PC5 for door 1: JTD must be written twice within four cycles, so no interrupt may come between. */
+	sreg = SYNC_enterCritical();
+	mcucsr = MCUCSR | (1 << JTD);
+	MCUCSR = mcucsr;
+	MCUCSR = mcucsr;
+	SYNC_exitCritical(sreg);
+#endif
+
+	ADC_init(&ADC_config);
+	ADC_setCallBack(DOOR_currentSample);
+
+	for(door = 0; door < DOOR_COUNT; door++)
+	{
+		channels |= (1 << pgm_read_byte(&g_doorConfig[door].currentChannel));
+		DOOR_enterState(door, DOOR_IDLE, 0);
+
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+		DOOR_setupLimit(pgm_read_byte(&g_doorConfig[door].openLimitPort), pgm_read_byte(&g_doorConfig[door].openLimitPin),
+				pgm_read_byte(&g_doorConfig[door].openLimitLine));
+		DOOR_setupLimit(pgm_read_byte(&g_doorConfig[door].closedLimitPort), pgm_read_byte(&g_doorConfig[door].closedLimitPin),
+				pgm_read_byte(&g_doorConfig[door].closedLimitLine));
+#endif
+	}
+	ADC_setChannels(channels);
+}
+
+/*
+ * Description:
+ * Start a full door cycle (opening, holding, closing).
+ * Return TRUE if the cycle started, FALSE if the door is busy, in fault or does not exist.
+ */
+uint8 DOOR_open(uint8 door)
+{
+	if((door >= DOOR_COUNT) || (g_doors[door].state != DOOR_IDLE))
+	{
+		return FALSE;
+	}
+
+	DOOR_enterState(door, DOOR_OPENING, DOOR_TRAVEL_TICKS);
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Emergency re-open while a cycle is running.
+ * While closing, the motor reverses and opens the door again.
+ * While holding, the holding time restarts. The idle door is not opened (it needs a password).
+ * Return TRUE if the request is accepted.
+ */
+uint8 DOOR_reopen(uint8 door)
+{
+	if(door >= DOOR_COUNT)
+	{
+		return FALSE;
+	}
+
+	switch(g_doors[door].state)
+	{
+	case DOOR_OPENING:
+		/* Already opening, nothing to do. */
+		return TRUE;
+
+	case DOOR_HOLDING:
+		DOOR_enterState(door, DOOR_HOLDING, DOOR_HOLD_TICKS);
+		return TRUE;
+
+	case DOOR_CLOSING:
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+		/* The open limit switch ends the travel wherever the door is. */
+		DOOR_enterState(door, DOOR_OPENING, DOOR_TRAVEL_TICKS);
+#else
+		/* The door is only open as far as it already closed, so open it back for the same time. */
+		DOOR_enterState(door, DOOR_OPENING, g_doors[door].ticksElapsed);
+#endif
+		return TRUE;
+
+	default:
+		return FALSE;
+	}
+}
+
+/*
+ * Description:
+ * Stop the motor immediately and latch the fault state until DOOR_clearFault() is called.
+ */
+void DOOR_fault(uint8 door)
+{
+	if(door < DOOR_COUNT)
+	{
+		DOOR_enterState(door, DOOR_FAULT, 0);
+	}
+}
+
+/*
+ * Description:
+ * Leave the fault state by closing the door again: the door is idle when it is closed, or in fault again
+ * if the close fails too. Return TRUE if the close started, FALSE if the door is not in fault.
+ */
+uint8 DOOR_clearFault(uint8 door)
+{
+	if((door >= DOOR_COUNT) || (g_doors[door].state != DOOR_FAULT))
+	{
+		return FALSE;
+	}
+
+	/* The door may have stopped anywhere, the closed limit switch or the travel time ends the close. */
+	DOOR_enterState(door, DOOR_CLOSING, DOOR_TRAVEL_TICKS);
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Advance the state machines of all the doors by one timer tick. Must be called from the main loop for every timer event.
+ */
+void DOOR_tick(void)
+{
+	uint8 door;
+
+	for(door = 0; door < DOOR_COUNT; door++)
+	{
+		DOOR_tickDoor(door);
+	}
+}
+
+/*
+ * Description:
+ * Handle an external interrupt event from the main loop. A door stops at once if the event is
+ * the limit switch of its travel and the switch is still pressed. Other lines are ignored.
+ */
+void DOOR_limitEvent(GPIO_ExternalInterruptType line)
+{
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+	uint8 door;
+
+	for(door = 0; door < DOOR_COUNT; door++)
+	{
+		if(((line == pgm_read_byte(&g_doorConfig[door].openLimitLine)) || (line == pgm_read_byte(&g_doorConfig[door].closedLimitLine)))
+				&& DOOR_isLimitReached(door))
+		{
+			DOOR_travelFinished(door);
+		}
+	}
+#endif
+}
+
+/*
+ * Description:
+ * Handle the motor stalls found by the current measurement. Must be called from the main loop on each pass.
+ * The motor is already stopped by the ADC ISR, this decides what the door does next:
+ * with limit switches a stall while closing is an obstruction (the door opens again) and a stall while opening
+ * is a fault, without them a stall is the end of the travel.
+ */
+void DOOR_poll(void)
+{
+	uint8 door;
+
+	for(door = 0; door < DOOR_COUNT; door++)
+	{
+		if(SYNC_takeFlag(&g_doors[door].stalled) == FALSE)
+		{
+			continue;
+		}
+
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+		if(g_doors[door].state == DOOR_CLOSING)
+		{
+			DOOR_reopen(door);
+		}
+		else if(g_doors[door].state == DOOR_OPENING)
+		{
+			DOOR_fault(door);
+		}
+#else
+		DOOR_travelFinished(door);
+#endif
+	}
+}
+
+/*
+ * Description:
+ * Return the current state of the door (DOOR_FAULT if the door does not exist).
+ */
+DOOR_State DOOR_getState(uint8 door)
+{
+	if(door >= DOOR_COUNT)
+	{
+		return DOOR_FAULT;
+	}
+	return g_doors[door].state;
+}
+
+/*
+ * Description:
+ * Advance the state machine of one door by one timer tick.
+ */
+static void DOOR_tickDoor(uint8 door)
+{
+	DOOR_Type *door_ptr = &g_doors[door];
+
+	/* Idle and fault states are not timed. */
+	if((door_ptr->state == DOOR_IDLE) || (door_ptr->state == DOOR_FAULT))
+	{
+		return;
+	}
+
+	door_ptr->ticksElapsed++;
+
+	/* The motor finished its start, a high current from now is a stall. */
+	if((door_ptr->ticksElapsed == DOOR_STALL_BLANK_TICKS) && (door_ptr->state != DOOR_HOLDING))
+	{
+		door_ptr->stallArmed = TRUE;
+	}
+
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+	/* Check the switch level each tick too, in case the edge came before the travel started or the switch has no interrupt. */
+	if(DOOR_isLimitReached(door))
+	{
+		DOOR_travelFinished(door);
+		return;
+	}
+#endif
+
+	/* Check if the current state still has time left. */
+	if(door_ptr->ticksRemaining > 1)
+	{
+		door_ptr->ticksRemaining--;
+		return;
+	}
+
+	/* Time of the current state is finished, go to the next one. */
+	switch(door_ptr->state)
+	{
+	case DOOR_OPENING:
+	case DOOR_CLOSING:
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+		DOOR_fault(door);							/* The door did not reach its limit switch in time. */
+#else
+		DOOR_travelFinished(door);
+#endif
+		break;
+	case DOOR_HOLDING:
+		DOOR_enterState(door, DOOR_CLOSING, DOOR_TRAVEL_TICKS);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Description:
+ * The opening or closing travel is finished, go to holding or idle.
+ */
+static void DOOR_travelFinished(uint8 door)
+{
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+	DCMotor_stopNow(pgm_read_byte(&g_doorConfig[door].motor));	/* The door is at its end, do not ramp down into the stop. */
+#endif
+
+	if(g_doors[door].state == DOOR_OPENING)
+	{
+		DOOR_enterState(door, DOOR_HOLDING, DOOR_HOLD_TICKS);
+	}
+	else if(g_doors[door].state == DOOR_CLOSING)
+	{
+		DOOR_enterState(door, DOOR_IDLE, 0);
+	}
+}
+
+#if(DOOR_LIMIT_SWITCHES == TRUE)
+/*
+ * Description:
+ * Return TRUE if the limit switch at the end of the current travel of the door is pressed.
+ */
+static uint8 DOOR_isLimitReached(uint8 door)
+{
+	switch(g_doors[door].state)
+	{
+	case DOOR_OPENING:
+		return (GPIO_readPin(pgm_read_byte(&g_doorConfig[door].openLimitPort), pgm_read_byte(&g_doorConfig[door].openLimitPin)) == LOGIC_LOW);
+	case DOOR_CLOSING:
+		return (GPIO_readPin(pgm_read_byte(&g_doorConfig[door].closedLimitPort), pgm_read_byte(&g_doorConfig[door].closedLimitPin)) == LOGIC_LOW);
+	default:
+		return FALSE;
+	}
+}
+
+/*
+ * Description:
+ * Enable the pull-up of a limit switch and its interrupt if it is on an external interrupt line.
+ */
+static void DOOR_setupLimit(uint8 port, uint8 pin, uint8 line)
+{
+	/* The pull-up is enabled first so a floating line does not give a false press. */
+	GPIO_setupPinDirection(port, pin, PIN_INPUT);
+	GPIO_writePin(port, pin, LOGIC_HIGH);
+	if(line != DOOR_NO_INTERRUPT)
+	{
+		GPIO_enableExternalInterrupt((GPIO_ExternalInterruptType)line, GPIO_FALLING_EDGE, NULL_PTR);
+	}
+}
+#endif
+
+/*
+ * Description:
+ * Called by the ADC ISR with each filtered motor current, stops the motor at once when it stalls.
+ */
+static void DOOR_currentSample(uint8 channel, uint16 average)
+{
+	DOOR_Type *door_ptr;
+	uint8 door;
+
+	/* Find the door measured on this channel */
+	for(door = 0; door < DOOR_COUNT; door++)
+	{
+		if(pgm_read_byte(&g_doorConfig[door].currentChannel) == channel)
+		{
+			break;
+		}
+	}
+	if(door == DOOR_COUNT)
+	{
+		return;
+	}
+	door_ptr = &g_doors[door];
+
+	if((door_ptr->stallArmed == FALSE) || (average < DOOR_STALL_CURRENT))
+	{
+		door_ptr->stallSamples = 0;
+		return;
+	}
+
+	if(++door_ptr->stallSamples >= DOOR_STALL_SAMPLES)
+	{
+		DCMotor_stopNow(pgm_read_byte(&g_doorConfig[door].motor));
+		door_ptr->stallArmed = FALSE;
+		door_ptr->stallSamples = 0;
+		SYNC_setFlag(&door_ptr->stalled);
+	}
+}
+
+/*
+ * Description:
+ * Move the door to a new state, drive the motor for that state and load its time.
+ * The ADC runs while at least one door is moving.
+ */
+static void DOOR_enterState(uint8 door, DOOR_State state, uint16 ticks)
+{
+	DOOR_Type *door_ptr = &g_doors[door];
+	uint8 motor = pgm_read_byte(&g_doorConfig[door].motor);
+	uint8 moving = FALSE;
+	uint8 i;
+
+	/* Each travel starts with the current check off until the motor start is finished. */
+	door_ptr->stallArmed = FALSE;
+	if((state != DOOR_OPENING) && (state != DOOR_CLOSING))
+	{
+		SYNC_takeFlag(&door_ptr->stalled);			/* A stall of the finished travel is not needed any more. */
+	}
+
+	door_ptr->state = state;
+	door_ptr->ticksRemaining = ticks;
+	door_ptr->ticksElapsed = 0;
+
+	for(i = 0; i < DOOR_COUNT; i++)
+	{
+		if((g_doors[i].state == DOOR_OPENING) || (g_doors[i].state == DOOR_CLOSING))
+		{
+			moving = TRUE;
+		}
+	}
+	if(moving)
+	{
+		ADC_start();
+	}
+	else
+	{
+		ADC_stop();
+	}
+
+	switch(state)
+	{
+	case DOOR_OPENING:
+		DCMotor_rotate(motor, CW, DOOR_MOTOR_SPEED);		/* Rotate the motor clock wise to open the door. */
+		break;
+	case DOOR_CLOSING:
+		DCMotor_rotate(motor, CCW, DOOR_MOTOR_SPEED);		/* Rotate the motor Anti-clock wise to close the door. */
+		break;
+	case DOOR_FAULT:
+		DCMotor_stopNow(motor);								/* Fault stops the motor without the ramp. */
+		break;
+	default:
+		DCMotor_rotate(motor, STOP, DOOR_MOTOR_SPEED);		/* Idle and holding states slow the motor down to stop. */
+		break;
+	}
+}
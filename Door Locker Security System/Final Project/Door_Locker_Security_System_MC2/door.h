@@ -0,0 +1,172 @@
+ /******************************************************************************
+ *
+ * Module: DOOR
+ *
+ * File Name: door.h
+ *
+ * Description: Header file for the door actuation state machine
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef DOOR_H_
+#define DOOR_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+#include "gpio.h"
+#include "timer.h"
+
+/******************************************************************************
+ *									 Definitions							  *
+ ******************************************************************************/
+#define DOOR_MOTOR_SPEED					100			/* it is a percentage from 0 to 100. */
+
+/*
+ * The door travels for 11.75 seconds.
+ * The ramp runs from the Timer2 ISR in real time: 255 / DC_RAMP_STEP = 51 steps of 10 ms, about 0.5 second
+ * up and 0.5 second down, so this moves the door as far as the old 15 seconds at 75% without ramps:
+ * 100% * (11.75 - 0.5) = 75% * 15.
+ */
+#define DOOR_OPEN_CLOSE_TICKS				TIMER_MS_TO_TICKS(11750)
+#define DOOR_HOLD_TICKS						TIMER_MS_TO_TICKS(3000)		/* The door stays open for 3 seconds. */
+
+#define DOOR_COUNT							2			/* Number of doors driven by this ECU, door n uses motor n of dc_motor.h. */
+
+/*
+ * Limit switches (to ground, internal pull-up) end the travel as soon as the door arrives.
+ * With DOOR_LIMIT_SWITCHES = FALSE the door travels for DOOR_OPEN_CLOSE_TICKS as before.
+ * With TRUE, not reaching the switch in DOOR_TRAVEL_TIMEOUT_TICKS is a fault (jammed door or broken switch).
+ * A switch on an external interrupt line stops the door at once, the others are checked each tick.
+ */
+#define DOOR_LIMIT_SWITCHES					TRUE
+#define DOOR_TRAVEL_TIMEOUT_TICKS			TIMER_MS_TO_TICKS(15000)	/* A travel longer than 15 seconds is a fault. */
+#define DOOR_NO_INTERRUPT					NUM_OF_EXTERNAL_INTERRUPTS	/* The switch is not on an interrupt line. */
+
+/* Door 0: open limit PD3 (INT1), closed limit PB2 (INT2), motor current on ADC0 (PA0) */
+#define DOOR0_OPEN_LIMIT_PORT_ID			INT1_PORT_ID
+#define DOOR0_OPEN_LIMIT_PIN_ID				INT1_PIN_ID
+#define DOOR0_OPEN_LIMIT_LINE				GPIO_INT1
+#define DOOR0_CLOSED_LIMIT_PORT_ID			INT2_PORT_ID
+#define DOOR0_CLOSED_LIMIT_PIN_ID			INT2_PIN_ID
+#define DOOR0_CLOSED_LIMIT_LINE				GPIO_INT2
+#define DOOR0_CURRENT_CHANNEL				0
+
+/*
+ * Door 1: open limit PC4, closed limit PC5 (checked each tick), motor current on ADC1 (PA1).
+ * Its motor (PC2, PC3) and limits are on the JTAG pins (TCK, TMS, TDO, TDI). The JTAGEN fuse is programmed
+ * in new chips, so DOOR_init() disables the JTAG interface with the JTD bit. Unprogram JTAGEN (high fuse
+ * bit 6 = 1) to free the pins from reset too; JTAG debugging of MC2 is not possible with two doors.
+ */
+#define DOOR1_OPEN_LIMIT_PORT_ID			PORTC_ID
+#define DOOR1_OPEN_LIMIT_PIN_ID				PIN4_ID
+#define DOOR1_OPEN_LIMIT_LINE				DOOR_NO_INTERRUPT
+#define DOOR1_CLOSED_LIMIT_PORT_ID			PORTC_ID
+#define DOOR1_CLOSED_LIMIT_PIN_ID			PIN5_ID
+#define DOOR1_CLOSED_LIMIT_LINE				DOOR_NO_INTERRUPT
+#define DOOR1_CURRENT_CHANNEL				1
+
+/*
+ * Motor current is measured on a shunt resistor of each door while it is moving.
+ * Stall current: 1 A through 0.5 ohm = 0.5 V = 102 with the AVCC (5 V) reference.
+ * The ADC converts every 208 us (62.5 kHz ADC clock) and the channels take turns,
+ * so 24 / DOOR_COUNT samples above the stall current are 5 ms.
+ * The start current is not checked during DOOR_STALL_BLANK_TICKS after the motor starts (1 second covers
+ * the 0.5 second ramp from stop and the 0.5 + 0.5 second reversal of a re-open).
+ */
+#define DOOR_STALL_CURRENT					102
+#define DOOR_STALL_SAMPLES					(24 / DOOR_COUNT)
+#define DOOR_STALL_BLANK_TICKS				TIMER_MS_TO_TICKS(1000)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum
+{
+	DOOR_IDLE, DOOR_OPENING, DOOR_HOLDING, DOOR_CLOSING, DOOR_FAULT
+}DOOR_State;
+
+/* Hardware of one door */
+typedef struct
+{
+	uint8 motor;						/* Motor number in dc_motor. */
+	uint8 openLimitPort;
+	uint8 openLimitPin;
+	uint8 openLimitLine;				/* GPIO_ExternalInterruptType of the switch or DOOR_NO_INTERRUPT. */
+	uint8 closedLimitPort;
+	uint8 closedLimitPin;
+	uint8 closedLimitLine;
+	uint8 currentChannel;				/* ADC channel of the motor current. */
+}DOOR_ConfigType;
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Stop the motors and put all the doors in the idle (closed) state.
+ * Enable the interrupts of the limit switches if they are used and the motor current measurement.
+ */
+void DOOR_init(void);
+
+/*
+ * Description:
+ * Start a full door cycle (opening, holding, closing).
+ * Return TRUE if the cycle started, FALSE if the door is busy, in fault or does not exist.
+ */
+uint8 DOOR_open(uint8 door);
+
+/*
+ * Description:
+ * Emergency re-open while a cycle is running.
+ * While closing, the motor reverses and opens the door again.
+ * While holding, the holding time restarts. The idle door is not opened (it needs a password).
+ * Return TRUE if the request is accepted.
+ */
+uint8 DOOR_reopen(uint8 door);
+
+/*
+ * Description:
+ * Stop the motor immediately and latch the fault state until DOOR_clearFault() is called.
+ */
+void DOOR_fault(uint8 door);
+
+/*
+ * Description:
+ * Leave the fault state by closing the door again: the door is idle when it is closed, or in fault again
+ * if the close fails too. Return TRUE if the close started, FALSE if the door is not in fault.
+ */
+uint8 DOOR_clearFault(uint8 door);
+
+/*
+ * Description:
+ * Advance the state machines of all the doors by one timer tick. Must be called from the main loop for every timer event.
+ */
+void DOOR_tick(void);
+
+/*
+ * Description:
+ * Handle an external interrupt event from the main loop. A door stops at once if the event is
+ * the limit switch of its travel and the switch is still pressed. Other lines are ignored.
+ */
+void DOOR_limitEvent(GPIO_ExternalInterruptType line);
+
+/*
+ * Description:
+ * Handle the motor stalls found by the current measurement. Must be called from the main loop on each pass.
+ * The motor is already stopped by the ADC ISR, this decides what the door does next:
+ * with limit switches a stall while closing is an obstruction (the door opens again) and a stall while opening
+ * is a fault, without them a stall is the end of the travel.
+ */
+void DOOR_poll(void);
+
+/*
+ * Description:
+ * Return the current state of the door (DOOR_FAULT if the door does not exist).
+ */
+DOOR_State DOOR_getState(uint8 door);
+
+#endif /* DOOR_H_ */
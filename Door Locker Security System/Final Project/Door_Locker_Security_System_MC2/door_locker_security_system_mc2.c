@@ -4,14 +4,14 @@
  Author      : Abdelrahman Ehab
  Description : A door is locked by a password.
  	 	 	   If you write the password correctly the door will open.
-  	  	  	   when you enter the password 3 times wrong, the buzzer will be activated for 1 minute.
+  	  	  	   when you enter the password 3 times wrong, the door is locked for 1 minute (longer for each next lockout)
+  	  	  	   and the buzzer will be activated for 1 minute.
+  	  	  	   Factory reset: hold the exit button while the lock is powered up until the success sound (5 seconds).
+  	  	  	   The saved password and the lockout are erased and MC1 asks for a new first password.
  Date        : 1/11/2021
  ================================================================================================
  */
 
-/* Change CPU frequency to 8000000 */
-#define F_CPU 8000000UL
-
 /*******************************************************************************
  *                    	     	Include Header	                               *
  *******************************************************************************/
@@ -20,8 +20,14 @@
 #include <util/delay.h>
 #include "buzzer.h"
 #include "dc_motor.h"
+#include "door.h"
 #include "external_eeprom.h"
+#include "gpio.h"
 #include "i2c.h"
+#include "link.h"
+#include "lockout.h"
+#include "password.h"
+#include "ring_buffer.h"
 #include "uart.h"
 #include "timer.h"
 
@@ -31,220 +37,276 @@
 #define BAUD 								9600 		/* Baud rate */
 #define MC2_READY 							0x01 		/* Handshaking between MC1 and MC2 (if use pooling instead of interrupt in UART). */
 
-#define EEPROM_Password_first_ADDRESS		0x0300		/* Address of first place in memory in which the first value of the password is saved. */
+#define TIMER_BUZZER						TIMER_MS_TO_TICKS(60000UL)	/* The alarm sounds for 60 seconds at the start of a lockout. */
+#define TIMER_EVENTS_SIZE					8			/* Number of timer ticks that can wait for the main loop. */
+#define TIMER_TICK_EVENT					0x01		/* Event pushed by timer0 on each overflow. */
 
-#define MOTOR_SPEED							75			/* it is a percentage from 0 to 100. */
+#define EXIT_BUTTON_LINE					GPIO_INT0	/* Push button inside the room (PD2 to ground) that opens the door without a password. */
+#define EXIT_BUTTON_DOOR					0			/* The door opened by the exit button. */
+/* Edges of the button are ignored for 50 ms after a press, one more tick because the first one can come at once. */
+#define EXIT_BUTTON_DEBOUNCE_TICKS			(TIMER_MS_TO_TICKS(50) + 1)
 
-#define PASSWORD_SIZE						4	 		/* To set the password size with a name. */
-#define MAX_NUMBER_OF_ERRORS				3			/* This is the number of times available for the user to write the password wrong before the buzzer get activated. */
+/*
+ * Factory reset, the only way to replace a password that is not known any more: the exit button is inside
+ * the room, so holding it at power-up needs the same access as opening the door with it.
+ */
+#define FACTORY_RESET_HOLD_MS				5000		/* The exit button is held this long from power-up. */
+#define FACTORY_RESET_RELEASE_MS			10000		/* Longest wait for the release, a shorted button does not stop the start-up. */
+#define FACTORY_RESET_POLL_MS				10
 
-#define TIMER_OPEN_CLOSE_DOOR				233			/* This is the number of overflow required to make 15 seconds. */
-#define TIMER_HOLD_DOOR						46			/* This is the number of overflow required to make 3 seconds. */
-#define TIMER_BUZZER						930			/* This is the number of overflow required to make 60 seconds. */
+/* A command that waits for its bytes too long is dropped, the next byte is a new command. */
+#define COMMAND_TIMEOUT_TICKS				TIMER_MS_TO_TICKS(1000)		/* MC1 sends the command and its bytes together. */
+#define COMMAND_NEW_PASSWORD_TICKS			TIMER_MS_TO_TICKS(60000UL)	/* The user writes the new password twice after CORRECT_PASSWORD. */
+#define PASSWORD_DIGIT_MAX					9			/* Password bytes are keypad digits, a greater byte is a command. */
 
 /* Commands for making MC1 and MC2 can communicate with each other */
-#define FIRST_PASSWORD						0xF1 		/* This used to inform MC2 that the password will be changed by sending a byte from MC1 with a certain value. */
+#define DOOR_IN_FAULT						0xEE		/* Answer to a correct OPEN_DOOR when the door is stopped by a fault. */
+#define CLEAR_FAULT							0xEF		/* MC1 asks to close the door in fault again, MC2 answers with one DOOR_State byte. */
+#define DOOR_BUSY							0xF0		/* Answer to a correct OPEN_DOOR when the door can not start a cycle (moving). */
+#define NO_COMMAND							0x00		/* No command is waiting for its password bytes. */
+#define NEW_PASSWORD						0x01		/* Not sent by MC1: after a correct CHANGE_PASSWORD the next password bytes are the new password. */
+#define FIRST_PASSWORD						0xF1 		/* The first password of a new device, refused if a password is saved or during a lockout. */
 #define OPEN_DOOR							0xF2		/* This used to inform MC2 that the door will be opened by sending a byte from MC1 with a certain value. */
 #define OPEN_DOOR_SUCCESS					0xF3		/* To present on screen door is opening. */
 #define OPEN_DOOR_FAILED					0xF4		/* To present on screen Wrong password and ask the user to repeat entering the password. */
 #define CHANGE_PASSWORD						0xF5		/* This used to inform MC2 that the password will be changed by sending a byte from MC1 with a certain value. */
 #define CORRECT_PASSWORD					0xF6		/* To inform MC1 that the password MC2 received is correct. */
 #define WRONG_PASSWORD						0xF7		/* To inform MC1 that the password MC2 received is wrong. */
+#define DOOR_STATUS							0xF8		/* MC1 asks for the door state, MC2 answers with one DOOR_State byte. */
+#define EMERGENCY_OPEN						0xF9		/* MC1 asks to re-open the door during a running cycle, MC2 answers with one DOOR_State byte. */
+#define SELECT_DOOR							0xFA		/* MC1 selects the door of the next commands, followed by one byte with the door number. */
+#define LOCKED_OUT							0xFB		/* Answer to a password command while passwords are locked after too many wrong ones. */
+#define LOCKOUT_STATUS						0xFC		/* MC1 asks for the lockout (one for all the doors), MC2 answers with the seconds left in two bytes (high byte first), zero if not locked. */
+#define PASSWORD_STATUS						0xFD		/* MC1 asks if a password is saved, MC2 answers with PASSWORD_SAVED or NO_PASSWORD. */
+#define PASSWORD_SAVED						0xFE		/* A password is saved, FIRST_PASSWORD is refused. */
+#define NO_PASSWORD							0xFF		/* No password is saved yet, MC2 waits for FIRST_PASSWORD. */
 /******************************************************************************
  *							   Global Variables								  *
  ******************************************************************************/
 
-uint16 g_timerCounter = 0;								/* To count number of overflow required to reach required time. */
-uint8 g_timerFlag = 0;									/* To stop program in while loop until the timer finish counting. */
+RING_BUFFER_DEFINE(g_timerEvents, TIMER_EVENTS_SIZE);	/* Timer0 adds a tick event on each overflow, the main loop advances the door and the buzzer for each one. */
+
+uint16 g_buzzerCounter = 0;								/* Number of overflow left while the alarm is activated. */
+
+uint8 g_selectedDoor = 0;								/* The door of the door and password commands from MC1. */
 
-uint8 g_buzzerAccumulator = 0;							/* To make sure if the user write the password three times wrong the buzzer will be activated for 1 minute. This buzzer reset if the password is correct*/
+uint8 g_exitButtonTicks = 0;							/* Ticks left before the exit button is accepted again (contact bounce). */
+
+uint8 g_command = NO_COMMAND;							/* The command that is waiting for its password bytes from MC1. */
+uint8 g_commandDataCounter = 0;							/* Number of password bytes received for the waiting command. */
+uint16 g_commandTicks = 0;								/* Ticks left before the waiting command is dropped. */
+
+#if (PASSWORD_BENCHMARK == TRUE)
+PASSWORD_BenchmarkType g_passwordBenchmark;			/* Cycles of the password check measured at start-up. */
+#endif
 
 /*******************************************************************************
  *                    	     	Function Prototype 	                           *
  *******************************************************************************/
 /*
  * Description:
- * receive the password entered to open the door.
+ * Handle one byte received from MC1 without waiting for the rest of the command.
+ * Commands with password bytes are executed after receiving all of them, other commands are executed directly.
  */
-void PASSWORD_receiveData(uint8 *a_passwordReceiveData_ptr);
+void COMMAND_receiveByte(uint8 data, uint8 *a_passwordReceived_ptr);
 
 /*
- * Description:
- * Compare the received password with the password that saved in EEPROM.
- * If True send command to display on screen door is opening and active the motor for 33 second (15 CW, 3 HOLD, 15 CCW).
- * If false accumulate a counter for the buzzer and send command incorrect password to write the password again.
+ * Description;
+ * Count a wrong password and answer MC1 with the failed reply.
+ * When the failure starts a lockout, answer with LOCKED_OUT instead and activate the alarm for 60 seconds.
+ */
+void PASSWORD_wrongAttempt(uint8 failedReply);
+
+/*
+ * Description;
+ * Wait for the bytes of a command for the given number of ticks.
  */
-uint8 PASSWORD_compareFromMemory(uint8 *a_passwordReceiveData_ptr, uint8 *a_passwordSaved_ptr);
+void COMMAND_wait(uint8 command, uint16 ticks);
 
 /*
  * Description;
- * Receiving the password in an array from MC1.
- * Saving the password in EEPROM.
- * Extract Password values and saves it in another array for another uses.
+ * Drop the command that waits for its bytes.
  */
-void PASSWORD_receiveSaveMemory(uint16 eepromAddress,uint8 *passwordReceived, uint8 *passwordSaved);
+void COMMAND_cancel(void);
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while opening and closing the door.
+ * Return TRUE if the exit button is held for FACTORY_RESET_HOLD_MS from power-up.
+ * Return after the button is released, so its bounce does not open the door.
  */
-void TIMER0_delayOpenClose(void);
+uint8 FACTORY_isResetRequested(void);
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while holding the door.
+ * This function is called by Timer0 on each overflow to inform the main loop that a tick is passed.
  */
-void TIMER0_delayHold(void);
+void TIMER0_tick(void);
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while buzzer is actiavted.
+ * This function is called from the main loop for each tick to stop the alarm after 60 seconds.
  */
-void TIMER0_delayBuzzer(void);
+void ALARM_tick(void);
 
 /*******************************************************************************
  *                    	     	   Main Application                            *
  *******************************************************************************/
 int main(void)
 {
+	uint8 timerEvent;									/* Event taken from the timer events buffer. */
+	GPIO_ExternalInterruptType interruptLine;			/* Line of the event taken from the external interrupt events. */
 	uint8 passwordReceived[PASSWORD_SIZE];  			/* Receive password valued from MC1 in this array. */
-	uint8 passwordSaved[PASSWORD_SIZE];					/* Extract the password values that saved in EEPROM and save it in  this array for another uses. */
-	uint8 passwordReceiveData[PASSWORD_SIZE];			/* To receive the password that the user entered to open the door to compare it with the password saved in EEPROM. */
-
-	uint8 motorStatus = FALSE;							/* To open the door or not. */
-	uint8 receivedPasswordStatus = FALSE;				/* To know if the received password is correct or not. */
+	uint8 data;											/* Byte received from MC1. */
+	uint8 factoryReset;									/* TRUE if the password and the lockout were erased at start-up. */
 
 	/*********************************************
 	 *				Drivers initiation 			 *
 	 *********************************************/
+	/* Activate I2C with fast mode (baud rate = 400000 bps). */
+	I2C_ConfigType U2C_config = {F_SCL_1, FAST_MODE}; /* I2C registers configuration. */
+	I2C_init(&U2C_config);
+
+	/*
+	 * The internal pull-up keeps the exit button line high while it is released,
+	 * it is enabled first so a floating line does not give a false press.
+	 */
+	GPIO_writePinFast(INT0_PORT_ID, INT0_PIN_ID, LOGIC_HIGH);
+
+	/* Factory reset before the EEPROM is read, the button interrupt is enabled after its release. */
+	factoryReset = FACTORY_isResetRequested();
+	if(factoryReset)
+	{
+		PASSWORD_erase();
+		LOCKOUT_erase();
+	}
+
+	/* Read the lockout counters from the EEPROM, a lockout running before the reset starts again. */
+	LOCKOUT_init();
+
+	/* Read the salt and the hash of the saved password from the EEPROM. */
+	PASSWORD_init();
+
+#if (PASSWORD_BENCHMARK == TRUE)
+	/*
+	 * Measure the password check with the interrupts still disabled, before the buzzer and the motors use Timer1
+	 * and before Timer0 runs, so no ISR adds its cycles or its stack. Read the result with the debugger.
+	 */
+	PASSWORD_benchmark(&g_passwordBenchmark);
+#endif
+
 	/* Enable Global Interrupt I-Bit. */
 	SREG |= (1<<7);
 
-	/* Activate Buzzer */
+	/* Activate the buzzer tone output, the patterns play in the background from the timer ticks. */
 	BUZZER_init();
 
-	/* Activate DC-Motor */
+	/* Activate DC-Motor and put the door in idle state. */
 	DCMotor_init();
+	DOOR_init();
 
-	/* Initiate timer0 configuration. */
-	TIMER0_ConfigType TIMER0_config = {TIMER_OVERFLOW_MODE, OC0_DISCONNECTED, F_CPU_1024, DISABLE_CTC_INTERRUPT, ENABLE_OVF_INTERRUPT};
+	/* Activate the exit button on the falling edge. */
+	GPIO_enableExternalInterrupt(EXIT_BUTTON_LINE, GPIO_FALLING_EDGE, NULL_PTR);
 
-	/* Activate I2C with fast mode (baud rate = 400000 bps). */
-	I2C_ConfigType U2C_config = {F_SCL_1, FAST_MODE}; /* I2C registers configuration. */
-	I2C_init(&U2C_config);
+	/* Initiate timer0 configuration. The timer keeps running and each overflow is a tick for the door and the buzzer. */
+	TIMER0_ConfigType TIMER0_config = {TIMER_OVERFLOW_MODE, OC0_DISCONNECTED, F_CPU_1024, DISABLE_CTC_INTERRUPT, ENABLE_OVF_INTERRUPT, 0}; /* No compare value in overflow mode. */
+	TIMER_setCallBack(TIMER0_tick);
+	TIMER_init(&TIMER0_config);
+
+	if(factoryReset)
+	{
+		BUZZER_play(BUZZER_SUCCESS);					/* Tell the user the reset is done, the buzzer runs from the timer ticks. */
+	}
 
 	/* Activate UART with double speed and eight_bit character size. the baud rate = 9600 bps (using interrupt when receiving a bit). */
-	UART_ConfigType UART_config = {DOUBLE_SPEED, ASYNCHRONOUS, RISING, PARITY_DISABLED, ONE_STOP_BIT, EIGHT_BIT, RX_INTERRUPT_DISABLE, TX_INTERRUPT_DISABLE}; /* UART registers configuration */
+	UART_ConfigType UART_config = {DOUBLE_SPEED, ASYNCHRONOUS, RISING, PARITY_DISABLED, ONE_STOP_BIT, EIGHT_BIT, RX_INTERRUPT_ENABLE, TX_INTERRUPT_ENABLE}; /* UART registers configuration */
 	UART_init(BAUD, &UART_config);
 
+	/* Answer the handshake of MC1, the commands are accepted only in encrypted frames of the session. */
+	LINK_init(LINK_RESPONDER);
+
 	_delay_ms(500);
 
 
 	while(1)
 	{
 		/*
-		 * This Switch used to switch between commands that received from MC1
+		 * Serve the link all the time, even while the door is moving or the buzzer is activated.
+		 * Each byte is handled when its frame is checked, so the loop never waits for MC1.
 		 */
-		switch (UART_recieveByte())
+		if(LINK_receiveByte(&data))
 		{
-		/* Case 1: Set first password	*/
-		case FIRST_PASSWORD:
-			/* Receive the new password and save it in memory */
-			PASSWORD_receiveSaveMemory(EEPROM_Password_first_ADDRESS, passwordReceived, passwordSaved);
-			break;
+			COMMAND_receiveByte(data, passwordReceived);
+		}
 
-		/* Case 2: Opening door	*/
-		case OPEN_DOOR:
+		/*
+		 * A new handshake means MC1 may have been reset: the command waiting for its bytes, mostly the new password
+		 * armed by CHANGE_PASSWORD, is dropped so the next bytes of MC1 are not saved as a password.
+		 */
+		if(LINK_takeNewSession())
+		{
+			COMMAND_cancel();
+		}
 
-			PASSWORD_receiveData(passwordReceiveData);										/* Receive the password from MC2. */
-			motorStatus = PASSWORD_compareFromMemory(passwordReceiveData, passwordSaved);	/* Check if the password is correct of not. */
+		/* A motor stall is handled on this pass, the ADC ISR already stopped the motor. */
+		DOOR_poll();
 
-			/* If the password is correct, activate the motor to open and close the door. */
-			if(motorStatus == TRUE)
+		/* Advance the door and the buzzer for each timer tick, no tick is lost if the loop was busy. */
+		while(RING_BUFFER_pop(&g_timerEvents, &timerEvent))
+		{
+			DOOR_tick();
+			/* The EEPROM takes one byte each tick, the password is written when the lockout writes nothing. */
+			if(LOCKOUT_tick() == FALSE)
 			{
-				g_buzzerAccumulator = 0;					/* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
-
-				UART_sendByte(OPEN_DOOR_SUCCESS);			/* Send to MC1 that the door is opening. so, display on screen this information. */
-
-				DCMotor_rotate(CW, MOTOR_SPEED);			/* Start to rotate the motor clock wise with required speed percentage. */
-				TIMER_setCallBack(TIMER0_delayOpenClose);	/* This function will call TIMER0_delayHold() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-				TIMER_init(&TIMER0_config);					/* Activate timer0 to count 15 seconds. */
-				while(g_timerFlag != 1){}					/* Wait until the timer finish to continue in the code. */
-				g_timerFlag = 0;							/* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-				DCMotor_rotate(STOP, MOTOR_SPEED);			/* Stop the motor. */
-				TIMER_setCallBack(TIMER0_delayHold);		/* This function will call TIMER0_delayHold() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-				TIMER_init(&TIMER0_config);					/* Activate timer0 to count 3 seconds. */
-				while(g_timerFlag != 1){}					/* Wait until the timer finish to continue in the code. */
-				g_timerFlag = 0;							/* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-				DCMotor_rotate(CCW, MOTOR_SPEED);			/* Start to rotate the motor Anti-clock wise with required speed percentage. */
-				TIMER_setCallBack(TIMER0_delayOpenClose);	/* This function will call TIMER0_delayOpenClose() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-				TIMER_init(&TIMER0_config);					/* Activate timer0 to count 15 seconds. */
-				while(g_timerFlag != 1){}					/* Wait until the timer finish to continue in the code. */
-				g_timerFlag = 0;							/* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-				DCMotor_rotate(STOP, MOTOR_SPEED);			/* Stop the motor again. */
+				PASSWORD_tick();
 			}
-			else if(motorStatus == FALSE)
+			ALARM_tick();
+			BUZZER_tick();
+
+			if(g_exitButtonTicks != 0)
 			{
-				UART_sendByte(OPEN_DOOR_FAILED);			/* Send to MC1 that the password is wrong. so, display on screen this information. */
-				g_buzzerAccumulator++;						/* Increment the buzzer counter every time the user write wrong password */
+				g_exitButtonTicks--;
+			}
 
-				/* Check on the buzzer g_buzzerAccumulator. if not reach the maximum tries, a message will appear for a second to inform the user that he wrought a wrong password*/
-				if(g_buzzerAccumulator == MAX_NUMBER_OF_ERRORS)
+			/* Drop the command if MC1 did not send all its bytes in time. */
+			if(g_commandTicks != 0)
+			{
+				g_commandTicks--;
+				if(g_commandTicks == 0)
 				{
-					BUZZER_on();							/* Activate the buzzer for one minutes. */
-
-					TIMER_setCallBack(TIMER0_delayBuzzer);  /* This function will call TIMER0_delayBuzzer() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-					TIMER_init(&TIMER0_config);				/* Activate timer0 to count 60 seconds. */
-					while(g_timerFlag != 1){}				/* Wait until the timer finish to continue in the code. */
-					g_timerFlag = 0;						/* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-					BUZZER_off();							/* Deactivate the buzzer. */
-
-					g_buzzerAccumulator = 0;				/* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
+					COMMAND_cancel();
 				}
 			}
-			break;
-
-		/* Case 3: Change Password	*/
-		case CHANGE_PASSWORD:
-			PASSWORD_receiveData(passwordReceiveData);													/* Receive the password from MC2. */
-			receivedPasswordStatus = PASSWORD_compareFromMemory(passwordReceiveData, passwordSaved);	/* Check if the password is correct of not. */
-
-			/* If the password is correct, start changing the password. */
-			if(receivedPasswordStatus == TRUE)
-			{
-				g_buzzerAccumulator = 0;					/* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
-
-				UART_sendByte(CORRECT_PASSWORD);			/* Send to MC1 that the password is correct. so, start change the password */
+		}
 
-				/* Receive the new password and save it in memory */
-				PASSWORD_receiveSaveMemory(EEPROM_Password_first_ADDRESS, passwordReceived, passwordSaved);
-			}
-			else if(receivedPasswordStatus == FALSE)
+		/*
+		 * The exit button opens the closed door, or re-opens it while it is closing.
+		 * The limit switches end the door travel as soon as they are pressed.
+		 */
+		while(GPIO_getInterruptEvent(&interruptLine))
+		{
+			if(interruptLine == EXIT_BUTTON_LINE)
 			{
-				UART_sendByte(WRONG_PASSWORD);				/* Send to MC1 that the password is not correct. */
-				g_buzzerAccumulator++;						/* Increment the buzzer counter every time the user write wrong password */
-
-				/* Check on the buzzer g_buzzerAccumulator. if not reach the maximum tries, a message will appear for a second to inform the user that he wrought a wrong password*/
-				if(g_buzzerAccumulator == MAX_NUMBER_OF_ERRORS)
+				/* The contacts bounce for some ms, each bounce is a falling edge: take the first one only. */
+				if(g_exitButtonTicks != 0)
 				{
-					BUZZER_on();							/* Activate the buzzer for one minutes. */
-
-					TIMER_setCallBack(TIMER0_delayBuzzer);	/* This function will call TIMER0_delayBuzzer() function when timer0 finish counting. When this function is called the Timer0 will deactivated. */
-					TIMER_init(&TIMER0_config);				/* Activate timer0 to count 60 seconds. */
-					while(g_timerFlag != 1){}				/* Wait until the timer finish to continue in the code. */
-					g_timerFlag = 0;						/* Always after the timer flag become become on, the developer must make it zero again for another use. */
-
-					BUZZER_off();							/* Deactivate the buzzer. */
+					continue;
+				}
+				g_exitButtonTicks = EXIT_BUTTON_DEBOUNCE_TICKS;
 
-					g_buzzerAccumulator = 0;				/* Make the buzzer counter count from 0 again to count three times after each time the password is correct. */
+				BUZZER_play(BUZZER_KEY_CLICK);
+				if(DOOR_open(EXIT_BUTTON_DOOR) == FALSE)
+				{
+					DOOR_reopen(EXIT_BUTTON_DOOR);
 				}
 			}
-			break;
+			else
+			{
+				DOOR_limitEvent(interruptLine);
+			}
 		}
+
+		/* Send the answers of this pass to MC1 as one frame. */
+		LINK_flush();
 	}
 }
 
@@ -255,122 +317,264 @@ int main(void)
  *******************************************************************************/
 /*
  * Description:
- * receive the password entered to open the door.
+ * Handle one byte received from MC1 without waiting for the rest of the command.
+ * Commands with password bytes are executed after receiving all of them, other commands are executed directly.
  */
-void PASSWORD_receiveData(uint8 *a_passwordReceiveData_ptr)
+void COMMAND_receiveByte(uint8 data, uint8 *a_passwordReceived_ptr)
 {
-	uint8 counter = 0;
-	/* Receiving all 4 password characters from MC2 after confirming it is the required password to save */
-	for(counter = 0; counter < PASSWORD_SIZE; counter++)
+	uint8 command = g_command;
+	uint16 seconds;
+
+	/* No command is waiting for password bytes, so this byte is a new command. */
+	if(command == NO_COMMAND)
 	{
-		a_passwordReceiveData_ptr[counter] = UART_recieveByte();
-	}
-}
+		switch(data)
+		{
+		/* Commands followed by password bytes, wait for them. */
+		case FIRST_PASSWORD:
+		case OPEN_DOOR:
+		case CHANGE_PASSWORD:
+		case SELECT_DOOR:
+			COMMAND_wait(data, COMMAND_TIMEOUT_TICKS);
+			break;
 
-/*
- * Description:
- * Compare the received password with the password that saved in EEPROM.
- * If True send command to display on screen door is opening and active the motor for 33 second (15 CW, 3 HOLD, 15 CCW).
- * If false accumulate a counter for the buzzer and send command incorrect password to write the password again.
- */
-uint8 PASSWORD_compareFromMemory(uint8 *a_passwordReceiveData_ptr, uint8 *a_passwordSaved_ptr)
-{
-	uint8 compareCounter = 0;								/* to count values in both arrays. */
-	uint8 reference = 0;									/* To take a decision according to the all values are correctly equal or not. */
+		/* Status query, answer with the state of the selected door. */
+		case DOOR_STATUS:
+			LINK_sendByte(DOOR_getState(g_selectedDoor));
+			break;
+
+		/* Emergency re-open, only accepted while the selected door is in a cycle. */
+		case EMERGENCY_OPEN:
+			DOOR_reopen(g_selectedDoor);
+			LINK_sendByte(DOOR_getState(g_selectedDoor));
+			break;
+
+		/* Leave the fault of the selected door by closing it again, no password is needed to close a door. */
+		case CLEAR_FAULT:
+			DOOR_clearFault(g_selectedDoor);
+			LINK_sendByte(DOOR_getState(g_selectedDoor));
+			break;
+
+		/* Lockout query, answer with the seconds left of the lockout. */
+		case LOCKOUT_STATUS:
+			seconds = LOCKOUT_getRemainingSeconds();
+			LINK_sendByte((uint8)(seconds >> 8));
+			LINK_sendByte((uint8)seconds);
+			break;
+
+		/* Password query, MC1 asks for the first password only if none is saved. */
+		case PASSWORD_STATUS:
+			LINK_sendByte(PASSWORD_isSaved() ? PASSWORD_SAVED : NO_PASSWORD);
+			break;
+		}
+		return;
+	}
 
-	/* Compare each character from password received with password saved */
-	for(compareCounter = 0; compareCounter< PASSWORD_SIZE; compareCounter++)
+	/* Door selection has one byte only, a wrong door number keeps the old selection. */
+	if(command == SELECT_DOOR)
 	{
-		if(a_passwordReceiveData_ptr[compareCounter] == a_passwordSaved_ptr[compareCounter])
+		COMMAND_cancel();
+		if(data < DOOR_COUNT)
 		{
-			reference++;									/* This reference will be indicator to check if 4 characters are equal. */
+			g_selectedDoor = data;
 		}
+		return;
 	}
-	/* If the password is set correctly. */
-	if(reference == PASSWORD_SIZE)
+
+	/*
+	 * A byte that is not a digit is never saved: MC1 lost the command (reset while the new password was armed),
+	 * so drop the command and handle the byte as a new command.
+	 */
+	if(data > PASSWORD_DIGIT_MAX)
 	{
-		return TRUE;
+		COMMAND_cancel();
+		COMMAND_receiveByte(data, a_passwordReceived_ptr);
+		return;
 	}
 
-	/* Else return false to repeat the process. */
-	else
+	/* Save the password byte and wait for the rest of it. */
+	a_passwordReceived_ptr[g_commandDataCounter] = data;
+	g_commandDataCounter++;
+	if(g_commandDataCounter < PASSWORD_SIZE)
 	{
-		return FALSE;
+		return;
+	}
+
+	/* All password bytes are received, execute the command. */
+	COMMAND_cancel();
+
+	/*
+	 * No password is checked during a lockout, for any door, so the tries during the lockout are not counted.
+	 * The password is the same for all the doors, so selecting another door gives no new tries.
+	 */
+	if(((command == OPEN_DOOR) || (command == CHANGE_PASSWORD)) && LOCKOUT_isLocked())
+	{
+		LINK_sendByte(LOCKED_OUT);
+		return;
+	}
+
+	switch (command)
+	{
+	/* Case 1: Set first password	*/
+	case FIRST_PASSWORD:
+		/*
+		 * Only a new device takes a password without the old one. Once a password is saved it is changed with
+		 * CHANGE_PASSWORD only, so a reset of MC1 or a forged FIRST_PASSWORD can not replace it.
+		 */
+		if((PASSWORD_isSaved() == FALSE) && (LOCKOUT_isLocked() == FALSE))
+		{
+			PASSWORD_saveMemory(a_passwordReceived_ptr);
+		}
+		break;
+
+	/* New password after a correct CHANGE_PASSWORD */
+	case NEW_PASSWORD:
+		/* Save the salted hash of the new password in memory */
+		PASSWORD_saveMemory(a_passwordReceived_ptr);
+		break;
+
+	/* Case 2: Opening door	*/
+	case OPEN_DOOR:
+		/* If the password is correct, start the door cycle. The door state machine opens, holds and closes the door. */
+		if(PASSWORD_compareFromMemory(a_passwordReceived_ptr) == TRUE)
+		{
+			LOCKOUT_recordSuccess();					/* Count the wrong passwords from 0 again and reset the lockout time. */
+
+			/* Start the door cycle without waiting for it, MC1 is told the door is opening only if it really started. */
+			if(DOOR_open(g_selectedDoor) == TRUE)
+			{
+				LINK_sendByte(OPEN_DOOR_SUCCESS);		/* Send to MC1 that the door is opening. so, display on screen this information. */
+				BUZZER_play(BUZZER_SUCCESS);
+			}
+			else
+			{
+				/* The door is already moving or stopped by a fault, MC1 offers to close the door in fault. */
+				LINK_sendByte((DOOR_getState(g_selectedDoor) == DOOR_FAULT) ? DOOR_IN_FAULT : DOOR_BUSY);
+				BUZZER_play(BUZZER_ERROR);
+			}
+		}
+		else
+		{
+			PASSWORD_wrongAttempt(OPEN_DOOR_FAILED);	/* Send to MC1 that the password is wrong. so, display on screen this information. */
+		}
+		break;
+
+	/* Case 3: Change Password	*/
+	case CHANGE_PASSWORD:
+		/* If the password is correct, the next password bytes are the new password. */
+		if(PASSWORD_compareFromMemory(a_passwordReceived_ptr) == TRUE)
+		{
+			LOCKOUT_recordSuccess();					/* Count the wrong passwords from 0 again and reset the lockout time. */
+
+			LINK_sendByte(CORRECT_PASSWORD);			/* Send to MC1 that the password is correct. so, start change the password */
+			BUZZER_play(BUZZER_SUCCESS);
+			COMMAND_wait(NEW_PASSWORD, COMMAND_NEW_PASSWORD_TICKS);	/* Receive the new password and save it in memory. */
+		}
+		else
+		{
+			PASSWORD_wrongAttempt(WRONG_PASSWORD);		/* Send to MC1 that the password is not correct. */
+		}
+		break;
 	}
 }
 
 /*
- * Description:
- * Receiving the password in an array from MC1.
- * Saving the password in EEPROM.
- * Extract Password values and saves it in another array for another uses.
+ * Description;
+ * Count a wrong password and answer MC1 with the failed reply.
+ * When the failure starts a lockout, answer with LOCKED_OUT instead and activate the alarm for 60 seconds.
  */
-void PASSWORD_receiveSaveMemory(uint16 eepromAddress,uint8 *a_passwordReceived_ptr, uint8 *a_passwordSaved_ptr)
+void PASSWORD_wrongAttempt(uint8 failedReply)
 {
-	uint8 counter = 0;
-	/* Receiving all 4 password characters from MC2 after confirming it is the required password to save */
-	for(counter = 0; counter < PASSWORD_SIZE; counter++)
+	/* The lockout module counts the failures in the EEPROM, if it reach the maximum tries the passwords are locked. */
+	if(LOCKOUT_recordFailure() == TRUE)
 	{
-		a_passwordReceived_ptr[counter] = UART_recieveByte();
+		LINK_sendByte(LOCKED_OUT);
+		BUZZER_play(BUZZER_ALARM);						/* Activate the alarm for one minutes. */
+		g_buzzerCounter = TIMER_BUZZER;					/* ALARM_tick() will stop it after 60 seconds. */
 	}
-
-	/* Saving password values in external EEPROM
-	 * Extract the password values that saved in EEPROM and save it in another array
-	 */
-	counter = 0;
-	while(counter < PASSWORD_SIZE)
+	else
 	{
-		EEPROM_writeByte(eepromAddress, a_passwordReceived_ptr[counter]); /* Save each character in EEPROM */
-		_delay_ms(10);
-		EEPROM_readByte(eepromAddress, &a_passwordSaved_ptr[counter]);	  /* Take each character from EEPROM to compare with any new password that the user is going to write on the keypad.*/
-		counter++; 				/* Increment the counter */
-		eepromAddress++;		/* Increment the Address */
+		LINK_sendByte(failedReply);
+		BUZZER_play(BUZZER_ERROR);
 	}
 }
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while opening and closing the door.
+ * Wait for the bytes of a command for the given number of ticks.
+ */
+void COMMAND_wait(uint8 command, uint16 ticks)
+{
+	g_command = command;
+	g_commandDataCounter = 0;
+	g_commandTicks = ticks;
+}
+
+/*
+ * Description;
+ * Drop the command that waits for its bytes.
+ */
+void COMMAND_cancel(void)
+{
+	g_command = NO_COMMAND;
+	g_commandDataCounter = 0;
+	g_commandTicks = 0;
+}
+
+/*
+ * Description;
+ * Return TRUE if the exit button is held for FACTORY_RESET_HOLD_MS from power-up.
+ * Return after the button is released, so its bounce does not open the door.
  */
-void TIMER0_delayOpenClose(void)
+uint8 FACTORY_isResetRequested(void)
 {
-	g_timerCounter++;								/* For each interrupt this counter will increment by one. */
-
-	/* Check if the timer counter reach the required limit. */
-    if(g_timerCounter == TIMER_OPEN_CLOSE_DOOR)
-    {
-    	TIMER_deinit();								/* After the number of required interrupt is ended, the timer will stop by this function. */
-    	g_timerFlag = 1;							/* Open this flag will make the delay stop, must be closed again by the developer if he wants to use the delay function again. */
-        g_timerCounter = 0;							/* make timer counter zero again to be able to use it again and count up form zero. */
-    }
+	uint16 heldTime = 0;
+	uint16 releaseTime = 0;
+
+	while((GPIO_readPin(INT0_PORT_ID, INT0_PIN_ID) == LOGIC_LOW) && (heldTime < FACTORY_RESET_HOLD_MS))
+	{
+		_delay_ms(FACTORY_RESET_POLL_MS);
+		heldTime += FACTORY_RESET_POLL_MS;
+	}
+	if(heldTime == 0)
+	{
+		return FALSE;
+	}
+
+	while((GPIO_readPin(INT0_PORT_ID, INT0_PIN_ID) == LOGIC_LOW) && (releaseTime < FACTORY_RESET_RELEASE_MS))
+	{
+		_delay_ms(FACTORY_RESET_POLL_MS);
+		releaseTime += FACTORY_RESET_POLL_MS;
+	}
+	_delay_ms(FACTORY_RESET_POLL_MS * 5);				/* The contacts bounce for some ms after the release. */
+
+	return (heldTime >= FACTORY_RESET_HOLD_MS);
 }
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while holding the door.
+ * This function is called by Timer0 on each overflow to inform the main loop that a tick is passed.
  */
-void TIMER0_delayHold(void)
+void TIMER0_tick(void)
 {
-	g_timerCounter++;								/* For each interrupt this counter will increment by one. */
-    if(g_timerCounter == TIMER_HOLD_DOOR)
-    {
-        TIMER_deinit();								/* After the number of required interrupt is ended, the timer will stop by this function. */
-    	g_timerFlag = 1;							/* Open this flag will make the delay stop, must be closed again by the developer if he wants to use the delay function again. */
-        g_timerCounter = 0;							/* make timer counter zero again to be able to use it again and count up form zero. */
-    }
+	RING_BUFFER_push(&g_timerEvents, TIMER_TICK_EVENT);
 }
 
 /*
  * Description;
- * This function use Timer0 in AVR to delay display while buzzer is activated.
+ * This function is called from the main loop for each tick to stop the alarm after 60 seconds.
  */
-void TIMER0_delayBuzzer(void)
+void ALARM_tick(void)
 {
-	g_timerCounter++;								/* For each interrupt this counter will increment by one. */
-    if(g_timerCounter == TIMER_BUZZER)
-    {
-        TIMER_deinit();								/* After the number of required interrupt is ended, the timer will stop by this function. */
-    	g_timerFlag = 1;							/* Open this flag will make the delay stop, must be closed again by the developer if he wants to use the delay function again. */
-        g_timerCounter = 0;							/* make timer counter zero again to be able to use it again and count up form zero. */
-    }
+	/* Check if the buzzer is activated. */
+	if(g_buzzerCounter == 0)
+	{
+		return;
+	}
+
+	g_buzzerCounter--;
+	if(g_buzzerCounter == 0)
+	{
+		BUZZER_stop();									/* Stop the alarm. */
+	}
 }
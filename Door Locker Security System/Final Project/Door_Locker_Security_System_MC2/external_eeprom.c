@@ -16,6 +16,16 @@
 #include "external_eeprom.h"
 #include "i2c.h"
 #include <avr/io.h>
+#include <util/delay.h>
+
+/***************************************************************************
+ *  							Function Prototype						   *
+ ***************************************************************************/
+/*
+ * Description:
+ * Return TRUE if the memory answers its address, it does not while a write cycle is running.
+ */
+static uint8 EEPROM_isReady(uint16 u16addr);
 
 /***************************************************************************
  *  							Function Deceleration					   *
@@ -54,6 +64,38 @@ uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
     return SUCCESS;
 }
 
+/*
+ * Description:
+ * Save a value in memory and wait until the memory finished writing it, so it is kept after a reset.
+ * A write cycle already running is waited for first. Return ERROR after EEPROM_WRITE_TIMEOUT_MS.
+ */
+uint8 EEPROM_writeByteWait(uint16 u16addr, uint8 u8data)
+{
+	uint8 time = 0;
+
+	/* The address is not acknowledged while the last write is running, try again each 1 ms. */
+	while(EEPROM_writeByte(u16addr, u8data) == ERROR)
+	{
+		I2C_stop();
+		if(++time >= EEPROM_WRITE_TIMEOUT_MS)
+		{
+			return ERROR;
+		}
+		_delay_ms(1);
+	}
+
+	/* The byte is in the memory when it answers its address again. */
+	while(EEPROM_isReady(u16addr) == FALSE)
+	{
+		if(++time >= EEPROM_WRITE_TIMEOUT_MS)
+		{
+			return ERROR;
+		}
+		_delay_ms(1);
+	}
+	return SUCCESS;
+}
+
 /*
  * Description:
  * Read value from memory.
@@ -97,3 +139,25 @@ uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 
     return SUCCESS;
 }
+
+/*
+ * Description:
+ * Return TRUE if the memory answers its address, it does not while a write cycle is running.
+ */
+static uint8 EEPROM_isReady(uint16 u16addr)
+{
+	uint8 ready;
+
+	I2C_start();
+	if (I2C_getStatus() != I2C_START)
+	{
+		I2C_stop();
+		return FALSE;
+	}
+
+	I2C_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
+	ready = (I2C_getStatus() == I2C_MT_SLA_W_ACK);
+
+	I2C_stop();
+	return ready;
+}
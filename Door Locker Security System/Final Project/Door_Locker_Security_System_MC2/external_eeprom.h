@@ -24,6 +24,8 @@
 #define ERROR 0
 #define SUCCESS 1
 
+#define EEPROM_WRITE_TIMEOUT_MS 20 /* The write cycle of the memory is 10 ms at most, with a margin for a write already running. */
+
 /***************************************************************************
  *  							Function Prototype						   *
  ***************************************************************************/
@@ -33,6 +35,13 @@
  */
 uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data);
 
+/*
+ * Description:
+ * Save a value in memory and wait until the memory finished writing it, so it is kept after a reset.
+ * A write cycle already running is waited for first. Return ERROR after EEPROM_WRITE_TIMEOUT_MS.
+ */
+uint8 EEPROM_writeByteWait(uint16 u16addr, uint8 u8data);
+
 /*
  * Description:
  * Read value from memory.
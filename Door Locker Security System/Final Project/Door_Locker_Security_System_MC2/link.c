@@ -0,0 +1,589 @@
+/****************************************************************************************
+ *
+ * Module: Link
+ *
+ * File Name: link.c
+ *
+ * Discretion: Source file for the encrypted and authenticated link between MC1 and MC2
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "link.h"
+#include "uart.h"
+#include <avr/io.h>
+#include <avr/eeprom.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define LINK_HELLO_SIZE					(2 * LINK_NONCE_SIZE)	/* Body of the HELLO answer: both nonces. */
+#define LINK_FRAME_OVERHEAD				(LINK_COUNTER_SIZE + POLY1305_TAG_SIZE)
+
+/*
+ * Each frame uses one ChaCha20 block: the first 32 bytes are the Poly1305 key of the frame and the
+ * next 32 bytes encrypt the payload (the same layout as NaCl secretbox). RFC 8439 uses a second block
+ * for the payload, this halves the cost of the small frames of this link.
+ */
+#define LINK_KEYSTREAM_OFFSET			POLY1305_KEY_SIZE
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* Place of the receiver in the frame */
+typedef enum
+{
+	LINK_WAIT_START, LINK_WAIT_TYPE, LINK_WAIT_LENGTH, LINK_WAIT_BODY
+}LINK_ReceiveState;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static LINK_RoleType g_linkRole = LINK_INITIATOR;
+static uint8 g_linkProvisioned = FALSE;						/* TRUE if the pre-shared key is written in the internal EEPROM. */
+static uint8 g_linkReady = FALSE;							/* TRUE when the session key is made. */
+static uint8 g_linkNewSession = FALSE;						/* TRUE after a handshake until the application takes it. */
+static uint8 g_linkSessionKey[CHACHA20_KEY_SIZE];
+static uint8 g_linkNonces[LINK_HELLO_SIZE];					/* Nonce of MC1 then nonce of MC2 of the last handshake. */
+static uint32 g_linkBootCounter = 0;						/* First 4 bytes of the own nonces, different after each reset. */
+static uint16 g_linkHandshakeCounter = 0;					/* Last 2 bytes of the own nonces, different for each handshake. */
+static uint16 g_linkHelloTimer = 0;							/* Time left before the initiator sends its HELLO again. */
+
+static uint32 g_linkTxCounter = 0;							/* Counter of the next sent frame. */
+static uint32 g_linkRxCounter = 0;							/* Lowest counter accepted for the next received frame, older frames are replays. */
+
+static uint8 g_linkTxPayload[LINK_PAYLOAD_MAX];				/* Bytes of the frame that is being built. */
+static uint8 g_linkTxLength = 0;
+static uint8 g_linkRxPayload[LINK_PAYLOAD_MAX];				/* Bytes of the last accepted frame. */
+static uint8 g_linkRxLength = 0;
+static uint8 g_linkRxRead = 0;								/* Bytes of the last accepted frame already taken by the application. */
+
+static LINK_ReceiveState g_linkRxState = LINK_WAIT_START;
+static uint8 g_linkFrameType = 0;
+static uint8 g_linkFrameLength = 0;
+static uint8 g_linkFrameIndex = 0;
+static uint8 g_linkFrameBody[LINK_BODY_MAX];				/* Body of the frame that is being received. */
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Write a new own nonce: boot counter then handshake counter.
+ */
+static void LINK_newNonce(uint8 *a_nonce_ptr);
+
+/*
+ * Description:
+ * Send a frame without encryption (handshake and resync frames).
+ */
+static void LINK_sendFrame(uint8 type, const uint8 *a_body_ptr, uint8 length);
+
+/*
+ * Description:
+ * Initiator: start a new handshake with a new nonce.
+ */
+static void LINK_sendHello(void);
+
+/*
+ * Description:
+ * Read the pre-shared key of the pair from the internal EEPROM.
+ * Return FALSE if the key is erased (the ECU is not provisioned).
+ */
+static uint8 LINK_readKey(uint8 *a_key_ptr);
+
+/*
+ * Description:
+ * Make the session key from the pre-shared key and both nonces, and start the frame counters from zero.
+ */
+static void LINK_startSession(void);
+
+/*
+ * Description:
+ * Encrypt and authenticate (a_open = FALSE) or check and decrypt (a_open = TRUE) the data of one frame in place.
+ * Return FALSE if the tag of a received frame is wrong, the data is not changed then.
+ */
+static uint8 LINK_crypt(uint8 direction, uint32 counter, uint8 *a_data_ptr, uint8 length, uint8 *a_tag_ptr, uint8 a_open);
+
+/*
+ * Description:
+ * Add one received UART byte to the frame, the complete frame is handled directly.
+ */
+static void LINK_receiveFrameByte(uint8 data);
+
+/*
+ * Description:
+ * Handle a complete received frame.
+ */
+static void LINK_handleFrame(void);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Start the link with no session. The boot counter in the internal EEPROM is incremented,
+ * so the handshake nonces are never used again after a reset. The initiator sends its HELLO directly.
+ * Must be called after UART_init().
+ */
+void LINK_init(LINK_RoleType role)
+{
+	uint8 key[CHACHA20_KEY_SIZE];
+
+	g_linkRole = role;
+	g_linkReady = FALSE;
+	g_linkTxLength = 0;
+	g_linkRxLength = 0;
+	g_linkRxRead = 0;
+	g_linkRxState = LINK_WAIT_START;
+
+	/* The write waits for the EEPROM (about 35 ms for 4 bytes), it is done once at start-up. */
+	g_linkBootCounter = eeprom_read_dword((const uint32 *)LINK_BOOT_COUNTER_EEPROM_ADDRESS) + 1;
+	eeprom_update_dword((uint32 *)LINK_BOOT_COUNTER_EEPROM_ADDRESS, g_linkBootCounter);
+	g_linkHandshakeCounter = 0;
+
+	/* Without a key there is no session, the commands are never sent or accepted. */
+	g_linkProvisioned = LINK_readKey(key);
+	if((role == LINK_INITIATOR) && g_linkProvisioned)
+	{
+		LINK_sendHello();
+	}
+}
+
+/*
+ * Description:
+ * Add one byte to the frame that is being built. A full frame is sent directly.
+ */
+void LINK_sendByte(uint8 data)
+{
+	if(g_linkTxLength == LINK_PAYLOAD_MAX)
+	{
+		LINK_flush();
+
+		/* No session: the frame is still full. */
+		if(g_linkTxLength == LINK_PAYLOAD_MAX)
+		{
+			return;
+		}
+	}
+	g_linkTxPayload[g_linkTxLength] = data;
+	g_linkTxLength++;
+}
+
+/*
+ * Description:
+ * Encrypt and send the bytes added since the last flush as one frame. Must be called from the main loop
+ * on each pass, so the bytes added while handling one event are sent together.
+ * The bytes are dropped if there is no session yet.
+ */
+void LINK_flush(void)
+{
+	uint8 body[LINK_BODY_MAX];
+	uint8 length = g_linkTxLength;
+	uint8 i;
+
+	/* Nothing to send, or no session yet: the bytes wait for the handshake. */
+	if((length == 0) || (g_linkReady == FALSE))
+	{
+		return;
+	}
+	g_linkTxLength = 0;
+
+	/* Counter in clear, the receiver needs it to make the key of the frame. */
+	body[0] = (uint8)g_linkTxCounter;
+	body[1] = (uint8)(g_linkTxCounter >> 8);
+	body[2] = (uint8)(g_linkTxCounter >> 16);
+	body[3] = (uint8)(g_linkTxCounter >> 24);
+	for(i = 0; i < length; i++)
+	{
+		body[LINK_COUNTER_SIZE + i] = g_linkTxPayload[i];
+	}
+	LINK_crypt(g_linkRole, g_linkTxCounter, &body[LINK_COUNTER_SIZE], length, &body[LINK_COUNTER_SIZE + length], FALSE);
+	g_linkTxCounter++;
+
+	LINK_sendFrame(LINK_FRAME_DATA, body, length + LINK_FRAME_OVERHEAD);
+}
+
+/*
+ * Description:
+ * Take the received UART bytes without waiting, check the frames and return the application bytes one by one.
+ * Return TRUE if a byte is written in the data pointer.
+ */
+uint8 LINK_receiveByte(uint8 *a_data_ptr)
+{
+	/* A new frame is accepted only after the application took all the bytes of the last one. */
+	while(g_linkRxRead == g_linkRxLength)
+	{
+		if(UART_isDataReceived() == FALSE)
+		{
+			return FALSE;
+		}
+		LINK_receiveFrameByte(UART_recieveByte());
+	}
+
+	*a_data_ptr = g_linkRxPayload[g_linkRxRead];
+	g_linkRxRead++;
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Return TRUE if the handshake is done and frames can be sent.
+ */
+uint8 LINK_isReady(void)
+{
+	return g_linkReady;
+}
+
+/*
+ * Description:
+ * Return TRUE once after each handshake, the other side may have been reset and lost its command state.
+ */
+uint8 LINK_takeNewSession(void)
+{
+	uint8 newSession = g_linkNewSession;
+
+	g_linkNewSession = FALSE;
+	return newSession;
+}
+
+/*
+ * Description:
+ * Advance the time of the link by the passed time, the initiator sends its HELLO again while it has no session.
+ */
+void LINK_tick(uint16 a_passedTime)
+{
+	if((g_linkRole != LINK_INITIATOR) || (g_linkReady == TRUE) || (g_linkProvisioned == FALSE))
+	{
+		return;
+	}
+
+	if(g_linkHelloTimer > a_passedTime)
+	{
+		g_linkHelloTimer -= a_passedTime;
+	}
+	else
+	{
+		LINK_sendHello();
+	}
+}
+
+#if (LINK_BENCHMARK == TRUE)
+/*
+ * Description:
+ * Measure the time to seal and to open a full frame in CPU cycles with Timer1. The Timer1 configuration
+ * is restored after, so it must be called at start-up before any Timer1 output is used.
+ */
+void LINK_benchmark(LINK_BenchmarkType *a_result_ptr)
+{
+	uint8 data[LINK_PAYLOAD_MAX] = {0};
+	uint8 tag[POLY1305_TAG_SIZE];
+	uint8 oldTCCR1A = TCCR1A;
+	uint8 oldTCCR1B = TCCR1B;
+
+	/* Normal mode, F_CPU/8: one count each 8 cycles, 524288 cycles before overflow. */
+	TCCR1A = 0;
+	TCCR1B = (1<<CS11);
+
+	TCNT1 = 0;
+	LINK_crypt(LINK_INITIATOR, 0, data, LINK_PAYLOAD_MAX, tag, FALSE);
+	a_result_ptr->sealCycles = (uint32)TCNT1 * 8;
+
+	TCNT1 = 0;
+	LINK_crypt(LINK_INITIATOR, 0, data, LINK_PAYLOAD_MAX, tag, TRUE);
+	a_result_ptr->openCycles = (uint32)TCNT1 * 8;
+
+	TCNT1 = 0;
+	TCCR1A = oldTCCR1A;
+	TCCR1B = oldTCCR1B;
+}
+#endif
+
+/*
+ * Description:
+ * Write a new own nonce: boot counter then handshake counter.
+ */
+static void LINK_newNonce(uint8 *a_nonce_ptr)
+{
+	g_linkHandshakeCounter++;
+
+	/* After 65536 handshakes in one boot the boot counter is used again, so the nonces never repeat. */
+	if(g_linkHandshakeCounter == 0)
+	{
+		g_linkBootCounter++;
+		eeprom_update_dword((uint32 *)LINK_BOOT_COUNTER_EEPROM_ADDRESS, g_linkBootCounter);
+	}
+
+	a_nonce_ptr[0] = (uint8)g_linkBootCounter;
+	a_nonce_ptr[1] = (uint8)(g_linkBootCounter >> 8);
+	a_nonce_ptr[2] = (uint8)(g_linkBootCounter >> 16);
+	a_nonce_ptr[3] = (uint8)(g_linkBootCounter >> 24);
+	a_nonce_ptr[4] = (uint8)g_linkHandshakeCounter;
+	a_nonce_ptr[5] = (uint8)(g_linkHandshakeCounter >> 8);
+}
+
+/*
+ * Description:
+ * Send a frame without encryption (handshake and resync frames).
+ */
+static void LINK_sendFrame(uint8 type, const uint8 *a_body_ptr, uint8 length)
+{
+	uint8 i;
+
+	UART_sendByte(LINK_START);
+	UART_sendByte(type);
+	UART_sendByte(length);
+	for(i = 0; i < length; i++)
+	{
+		UART_sendByte(a_body_ptr[i]);
+	}
+}
+
+/*
+ * Description:
+ * Initiator: start a new handshake with a new nonce.
+ */
+static void LINK_sendHello(void)
+{
+	g_linkReady = FALSE;
+	LINK_newNonce(g_linkNonces);
+	LINK_sendFrame(LINK_FRAME_HELLO, g_linkNonces, LINK_NONCE_SIZE);
+	g_linkHelloTimer = LINK_HELLO_RETRY_TIME;
+}
+
+/*
+ * Description:
+ * Read the pre-shared key of the pair from the internal EEPROM.
+ * Return FALSE if the key is erased (the ECU is not provisioned).
+ */
+static uint8 LINK_readKey(uint8 *a_key_ptr)
+{
+	uint8 erased = 0xFF;
+	uint8 i;
+
+	eeprom_read_block(a_key_ptr, (const void *)LINK_KEY_EEPROM_ADDRESS, CHACHA20_KEY_SIZE);
+	for(i = 0; i < CHACHA20_KEY_SIZE; i++)
+	{
+		erased &= a_key_ptr[i];
+	}
+	return (erased != 0xFF);
+}
+
+/*
+ * Description:
+ * Make the session key from the pre-shared key and both nonces, and start the frame counters from zero.
+ */
+static void LINK_startSession(void)
+{
+	uint8 key[CHACHA20_KEY_SIZE];
+	uint8 block[CHACHA20_BLOCK_SIZE];
+	uint8 i;
+
+	/*
+	 * Session key = first half of ChaCha20(pre-shared key, nonce of MC1 | nonce of MC2, block 0).
+	 * Each side adds a nonce it never used before, so a recorded session does not work again on either side.
+	 */
+	LINK_readKey(key);
+	CHACHA20_block(key, g_linkNonces, 0, block);
+	for(i = 0; i < CHACHA20_KEY_SIZE; i++)
+	{
+		g_linkSessionKey[i] = block[i];
+	}
+
+	/* The bytes added while there was no session are sent by the next flush. */
+	g_linkTxCounter = 0;
+	g_linkRxCounter = 0;
+	g_linkReady = TRUE;
+	g_linkNewSession = TRUE;
+}
+
+/*
+ * Description:
+ * Encrypt and authenticate (a_open = FALSE) or check and decrypt (a_open = TRUE) the data of one frame in place.
+ * Return FALSE if the tag of a received frame is wrong, the data is not changed then.
+ */
+static uint8 LINK_crypt(uint8 direction, uint32 counter, uint8 *a_data_ptr, uint8 length, uint8 *a_tag_ptr, uint8 a_open)
+{
+	uint8 nonce[CHACHA20_NONCE_SIZE] = {0};
+	uint8 block[CHACHA20_BLOCK_SIZE];
+	uint8 tag[POLY1305_TAG_SIZE];
+	uint8 i;
+
+	/* Nonce of the frame: sender then frame counter. The counter never repeats in a session for each sender. */
+	nonce[0] = direction;
+	nonce[4] = (uint8)counter;
+	nonce[5] = (uint8)(counter >> 8);
+	nonce[6] = (uint8)(counter >> 16);
+	nonce[7] = (uint8)(counter >> 24);
+	CHACHA20_block(g_linkSessionKey, nonce, 0, block);
+
+	/* The tag is made on the encrypted bytes, so a wrong frame is refused before it is decrypted. */
+	if(a_open == TRUE)
+	{
+		POLY1305_mac(block, a_data_ptr, length, tag);
+		if(POLY1305_verify(tag, a_tag_ptr) == FALSE)
+		{
+			return FALSE;
+		}
+	}
+
+	for(i = 0; i < length; i++)
+	{
+		a_data_ptr[i] ^= block[LINK_KEYSTREAM_OFFSET + i];
+	}
+
+	if(a_open == FALSE)
+	{
+		POLY1305_mac(block, a_data_ptr, length, a_tag_ptr);
+	}
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Add one received UART byte to the frame, the complete frame is handled directly.
+ */
+static void LINK_receiveFrameByte(uint8 data)
+{
+	switch(g_linkRxState)
+	{
+	case LINK_WAIT_START:
+		/* Bytes out of a frame (noise or the rest of a lost frame) are skipped up to the next start byte. */
+		if(data == LINK_START)
+		{
+			g_linkRxState = LINK_WAIT_TYPE;
+		}
+		break;
+
+	case LINK_WAIT_TYPE:
+		g_linkFrameType = data;
+		g_linkRxState = LINK_WAIT_LENGTH;
+		break;
+
+	case LINK_WAIT_LENGTH:
+		if(data > LINK_BODY_MAX)
+		{
+			g_linkRxState = LINK_WAIT_START;
+			break;
+		}
+		g_linkFrameLength = data;
+		g_linkFrameIndex = 0;
+		if(data == 0)
+		{
+			g_linkRxState = LINK_WAIT_START;
+			LINK_handleFrame();
+		}
+		else
+		{
+			g_linkRxState = LINK_WAIT_BODY;
+		}
+		break;
+
+	case LINK_WAIT_BODY:
+		g_linkFrameBody[g_linkFrameIndex] = data;
+		g_linkFrameIndex++;
+		if(g_linkFrameIndex == g_linkFrameLength)
+		{
+			g_linkRxState = LINK_WAIT_START;
+			LINK_handleFrame();
+		}
+		break;
+	}
+}
+
+/*
+ * Description:
+ * Handle a complete received frame.
+ */
+static void LINK_handleFrame(void)
+{
+	uint8 *body = g_linkFrameBody;
+	uint8 length;
+	uint32 counter;
+	uint8 i;
+
+	switch(g_linkFrameType)
+	{
+	case LINK_FRAME_HELLO:
+		if((g_linkRole == LINK_RESPONDER) && g_linkProvisioned && (g_linkFrameLength == LINK_NONCE_SIZE))
+		{
+			/* A new handshake replaces the session, answer with both nonces. */
+			for(i = 0; i < LINK_NONCE_SIZE; i++)
+			{
+				g_linkNonces[i] = body[i];
+			}
+			LINK_newNonce(&g_linkNonces[LINK_NONCE_SIZE]);
+			LINK_sendFrame(LINK_FRAME_HELLO, g_linkNonces, LINK_HELLO_SIZE);
+			LINK_startSession();
+		}
+		else if((g_linkRole == LINK_INITIATOR) && (g_linkReady == FALSE) && (g_linkFrameLength == LINK_HELLO_SIZE))
+		{
+			/* Only the answer to the last HELLO is taken, an old answer would make a different key than MC2. */
+			for(i = 0; i < LINK_NONCE_SIZE; i++)
+			{
+				if(body[i] != g_linkNonces[i])
+				{
+					return;
+				}
+			}
+			for(i = LINK_NONCE_SIZE; i < LINK_HELLO_SIZE; i++)
+			{
+				g_linkNonces[i] = body[i];
+			}
+			LINK_startSession();
+		}
+		break;
+
+	case LINK_FRAME_DATA:
+		if((g_linkReady == FALSE) || (g_linkFrameLength < LINK_FRAME_OVERHEAD))
+		{
+			if(g_linkRole == LINK_RESPONDER)
+			{
+				LINK_sendFrame(LINK_FRAME_RESYNC, NULL_PTR, 0);
+			}
+			return;
+		}
+
+		counter = ((uint32)body[3] << 24) | ((uint32)body[2] << 16) | ((uint16)body[1] << 8) | body[0];
+		length = g_linkFrameLength - LINK_FRAME_OVERHEAD;
+
+		/* A frame that was already accepted (or older) is a replay, it is dropped without any answer. */
+		if(counter < g_linkRxCounter)
+		{
+			return;
+		}
+
+		if(LINK_crypt(g_linkRole ^ 1, counter, &body[LINK_COUNTER_SIZE], length, &body[LINK_COUNTER_SIZE + length], TRUE) == FALSE)
+		{
+			/* Wrong key or changed frame: MC2 asks for a new handshake, in case the sides have different keys. */
+			if(g_linkRole == LINK_RESPONDER)
+			{
+				LINK_sendFrame(LINK_FRAME_RESYNC, NULL_PTR, 0);
+			}
+			return;
+		}
+
+		g_linkRxCounter = counter + 1;
+		for(i = 0; i < length; i++)
+		{
+			g_linkRxPayload[i] = body[LINK_COUNTER_SIZE + i];
+		}
+		g_linkRxLength = length;
+		g_linkRxRead = 0;
+		break;
+
+	case LINK_FRAME_RESYNC:
+		if((g_linkRole == LINK_INITIATOR) && (g_linkReady == TRUE))
+		{
+			LINK_sendHello();
+		}
+		break;
+
+	default:
+		break;
+	}
+}
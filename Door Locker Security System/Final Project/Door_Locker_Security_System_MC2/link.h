@@ -0,0 +1,143 @@
+/****************************************************************************************
+ *
+ * Module: Link
+ *
+ * File Name: link.h
+ *
+ * Discretion: Header file for the encrypted and authenticated link between MC1 and MC2.
+ * 			   The application bytes are sent in frames encrypted with ChaCha20 and authenticated
+ * 			   with Poly1305, under a session key made by a handshake from a pre-shared key.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef LINK_H_
+#define LINK_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+#include "chacha20.h"
+#include "poly1305.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*
+ * Frame on the UART: LINK_START, type, body length, body.
+ * HELLO body:  nonce of MC1 (from MC1), nonce of MC1 then nonce of MC2 (answer of MC2).
+ * DATA body:   frame counter (4 bytes, little endian), encrypted bytes, Poly1305 tag.
+ * RESYNC body: empty, MC2 asks MC1 for a new handshake because it has no session or a frame failed.
+ */
+#define LINK_START						0x7E
+#define LINK_FRAME_HELLO				0x01
+#define LINK_FRAME_DATA					0x02
+#define LINK_FRAME_RESYNC				0x03
+
+#define LINK_NONCE_SIZE					6			/* Bytes of the handshake nonce of each side. */
+#define LINK_COUNTER_SIZE				4			/* Bytes of the frame counter. */
+#define LINK_PAYLOAD_MAX				16			/* Application bytes in one frame. */
+#define LINK_BODY_MAX					(LINK_COUNTER_SIZE + LINK_PAYLOAD_MAX + POLY1305_TAG_SIZE)
+
+/*
+ * Internal EEPROM of each ECU: the pre-shared key of the MC1 and MC2 pair, then the boot counter.
+ * The key is not in the sources, it is written to both ECUs at provisioning (make link-key, see makefile.targets).
+ * An erased key (all 0xFF) means the ECU is not provisioned: it never starts or answers a handshake.
+ */
+#define LINK_KEY_EEPROM_ADDRESS			0x0000
+#define LINK_BOOT_COUNTER_EEPROM_ADDRESS	0x0020
+
+/*
+ * Time before MC1 sends its HELLO again while MC2 does not answer, in the unit of LINK_tick() (ms on MC1).
+ */
+#define LINK_HELLO_RETRY_TIME			500
+
+/*
+ * Cost of a frame, estimated for avr-gcc -O2 at 8 MHz (not measured, see LINK_BENCHMARK):
+ * one ChaCha20 block about 30000 cycles and one Poly1305 block about 6000 cycles.
+ * A frame up to 16 bytes takes one of each (about 36000 cycles = 4.5 ms) to seal or to open.
+ * Its time on the wire at 9600 baud is 1.04 ms for each byte, 24 + n bytes = 26 ms for a 2 byte command.
+ */
+#define LINK_BENCHMARK					FALSE
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum
+{
+	LINK_INITIATOR,						/* MC1: starts the handshake. */
+	LINK_RESPONDER						/* MC2: answers the handshake. */
+}LINK_RoleType;
+
+#if (LINK_BENCHMARK == TRUE)
+/* CPU cycles measured by LINK_benchmark() */
+typedef struct
+{
+	uint32 sealCycles;					/* Encrypt and authenticate a frame of LINK_PAYLOAD_MAX bytes. */
+	uint32 openCycles;					/* Check and decrypt the same frame. */
+}LINK_BenchmarkType;
+#endif
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Start the link with no session. The boot counter in the internal EEPROM is incremented,
+ * so the handshake nonces are never used again after a reset. The initiator sends its HELLO directly.
+ * Must be called after UART_init().
+ */
+void LINK_init(LINK_RoleType role);
+
+/*
+ * Description:
+ * Add one byte to the frame that is being built. A full frame is sent directly.
+ * Without a session the bytes wait for it, a byte that does not fit in LINK_PAYLOAD_MAX is dropped then.
+ */
+void LINK_sendByte(uint8 data);
+
+/*
+ * Description:
+ * Encrypt and send the bytes added since the last flush as one frame. Must be called from the main loop
+ * on each pass, so the bytes added while handling one event are sent together.
+ * The bytes are kept if there is no session yet, and sent by the first flush after the handshake.
+ */
+void LINK_flush(void);
+
+/*
+ * Description:
+ * Take the received UART bytes without waiting, check the frames and return the application bytes one by one.
+ * Return TRUE if a byte is written in the data pointer.
+ */
+uint8 LINK_receiveByte(uint8 *a_data_ptr);
+
+/*
+ * Description:
+ * Return TRUE if the handshake is done and frames can be sent.
+ */
+uint8 LINK_isReady(void);
+
+/*
+ * Description:
+ * Return TRUE once after each handshake, the other side may have been reset and lost its command state.
+ */
+uint8 LINK_takeNewSession(void);
+
+/*
+ * Description:
+ * Advance the time of the link by the passed time, the initiator sends its HELLO again while it has no session.
+ */
+void LINK_tick(uint16 a_passedTime);
+
+#if (LINK_BENCHMARK == TRUE)
+/*
+ * Description:
+ * Measure the time to seal and to open a full frame in CPU cycles with Timer1. The Timer1 configuration
+ * is restored after, so it must be called at start-up before any Timer1 output is used.
+ */
+void LINK_benchmark(LINK_BenchmarkType *a_result_ptr);
+#endif
+
+#endif /* LINK_H_ */
@@ -0,0 +1,283 @@
+ /******************************************************************************
+ *
+ * Module: LOCKOUT
+ *
+ * File Name: lockout.c
+ *
+ * Description: Source file for the wrong password lockout policy
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "lockout.h"
+#include "external_eeprom.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* Place of each counter in the record */
+#define LOCKOUT_FAILURES_OFFSET				0
+#define LOCKOUT_LEVEL_OFFSET				1
+#define LOCKOUT_LOCKED_OFFSET				2
+
+/*
+ * The changed bytes are written in this order, so a reset between two of them never gives more tries:
+ * the level is raised and the lock set before the failures are cleared, and the level is cleared
+ * before the failures on a correct password.
+ */
+#define LOCKOUT_WRITE_ORDER					{LOCKOUT_LEVEL_OFFSET, LOCKOUT_LOCKED_OFFSET, LOCKOUT_FAILURES_OFFSET}
+
+/* The longest lockout must fit in 16 bits (the array size is negative and the build fails if it does not) */
+typedef char LOCKOUT_sizeCheck[((LOCKOUT_BASE_TICKS << LOCKOUT_MAX_LEVEL) <= 0xFFFFUL) ? 1 : -1];
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_lockoutRecord[LOCKOUT_EEPROM_RECORD_SIZE];	/* Failures, level and locked flag, the same as the EEPROM. */
+static uint8 g_lockoutDirty = 0;							/* One bit for each record byte that is not written to the EEPROM yet. */
+static uint16 g_lockoutTicksRemaining = 0;					/* Time left of the lockout, zero if passwords are accepted. */
+static const uint8 g_lockoutWriteOrder[LOCKOUT_EEPROM_RECORD_SIZE] PROGMEM = LOCKOUT_WRITE_ORDER;
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Change one byte of the record, it is written to the EEPROM later by LOCKOUT_tick().
+ */
+static void LOCKOUT_setRecord(uint8 offset, uint8 value);
+
+/*
+ * Description:
+ * Start a lockout for the time of the current level.
+ */
+static void LOCKOUT_lock(void);
+
+/*
+ * Description:
+ * Write one changed record byte to the EEPROM. Return TRUE if a byte is written.
+ */
+static uint8 LOCKOUT_writeNext(void);
+
+/*
+ * Description:
+ * Write all the changed record bytes to the EEPROM and wait for each one.
+ */
+static void LOCKOUT_save(void);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Read the counters from the EEPROM. A lockout that was running at the reset starts again
+ * for the full time of its level. Must be called after I2C_init().
+ */
+void LOCKOUT_init(void)
+{
+	uint8 offset;
+
+	for(offset = 0; offset < LOCKOUT_EEPROM_RECORD_SIZE; offset++)
+	{
+		EEPROM_readByte(LOCKOUT_EEPROM_ADDRESS + offset, &g_lockoutRecord[offset]);
+	}
+	g_lockoutDirty = 0;
+	g_lockoutTicksRemaining = 0;
+
+	/* An erased EEPROM (0xFF) or a bad value starts from no failures. */
+	if(g_lockoutRecord[LOCKOUT_FAILURES_OFFSET] >= LOCKOUT_MAX_FAILURES)
+	{
+		LOCKOUT_setRecord(LOCKOUT_FAILURES_OFFSET, 0);
+	}
+	if(g_lockoutRecord[LOCKOUT_LEVEL_OFFSET] > LOCKOUT_MAX_LEVEL)
+	{
+		LOCKOUT_setRecord(LOCKOUT_LEVEL_OFFSET, 0);
+	}
+
+	if(g_lockoutRecord[LOCKOUT_LOCKED_OFFSET] == TRUE)
+	{
+		LOCKOUT_lock();
+	}
+	else
+	{
+		LOCKOUT_setRecord(LOCKOUT_LOCKED_OFFSET, FALSE);
+	}
+}
+
+/*
+ * Description:
+ * Clear the failures, the lockout level and the lock in the EEPROM and wait for it (factory reset).
+ * Must be called after I2C_init() and before LOCKOUT_init().
+ */
+void LOCKOUT_erase(void)
+{
+	uint8 offset;
+
+	/* All the counters are zero, and FALSE is zero too. */
+	for(offset = 0; offset < LOCKOUT_EEPROM_RECORD_SIZE; offset++)
+	{
+		EEPROM_writeByteWait(LOCKOUT_EEPROM_ADDRESS + offset, 0);
+	}
+}
+
+/*
+ * Description:
+ * Return TRUE if passwords are not accepted now.
+ */
+uint8 LOCKOUT_isLocked(void)
+{
+	return (g_lockoutTicksRemaining != 0);
+}
+
+/*
+ * Description:
+ * Count a wrong password and save it in the EEPROM before returning, so the answer to MC1 is sent after
+ * the failure is kept: turning the power off after a wrong password does not give a new try.
+ * Return TRUE if this failure started a lockout.
+ */
+uint8 LOCKOUT_recordFailure(void)
+{
+	uint8 failures;
+	uint8 locked = FALSE;
+
+	if(LOCKOUT_isLocked())
+	{
+		return FALSE;
+	}
+
+	failures = g_lockoutRecord[LOCKOUT_FAILURES_OFFSET] + 1;
+	if(failures < LOCKOUT_MAX_FAILURES)
+	{
+		LOCKOUT_setRecord(LOCKOUT_FAILURES_OFFSET, failures);
+	}
+	else
+	{
+		/* The failures start again after the lockout. */
+		LOCKOUT_setRecord(LOCKOUT_FAILURES_OFFSET, 0);
+		LOCKOUT_setRecord(LOCKOUT_LOCKED_OFFSET, TRUE);
+		LOCKOUT_lock();
+		locked = TRUE;
+	}
+
+	LOCKOUT_save();
+	return locked;
+}
+
+/*
+ * Description:
+ * A correct password: clear the failures and the lockout level.
+ */
+void LOCKOUT_recordSuccess(void)
+{
+	LOCKOUT_setRecord(LOCKOUT_FAILURES_OFFSET, 0);
+	LOCKOUT_setRecord(LOCKOUT_LEVEL_OFFSET, 0);
+}
+
+/*
+ * Description:
+ * Return the seconds left before passwords are accepted again, zero if there is no lockout.
+ */
+uint16 LOCKOUT_getRemainingSeconds(void)
+{
+	/* Rounded up so the doors are never shown as open while they are locked. */
+	return (uint16)TIMER_TICKS_TO_SECONDS(g_lockoutTicksRemaining);
+}
+
+/*
+ * Description:
+ * Count down the lockout and write the changed counters to the EEPROM, one byte each tick.
+ * The EEPROM write cycle (10 ms) ends before the next tick, so nothing waits for the EEPROM.
+ * Must be called from the main loop for every timer tick.
+ */
+uint8 LOCKOUT_tick(void)
+{
+	if(g_lockoutTicksRemaining != 0)
+	{
+		g_lockoutTicksRemaining--;
+		if(g_lockoutTicksRemaining == 0)
+		{
+			/* The lockout is finished, the next one is twice as long. */
+			LOCKOUT_setRecord(LOCKOUT_LOCKED_OFFSET, FALSE);
+			if(g_lockoutRecord[LOCKOUT_LEVEL_OFFSET] < LOCKOUT_MAX_LEVEL)
+			{
+				LOCKOUT_setRecord(LOCKOUT_LEVEL_OFFSET, g_lockoutRecord[LOCKOUT_LEVEL_OFFSET] + 1);
+			}
+		}
+	}
+
+	return LOCKOUT_writeNext();
+}
+
+/*
+ * Description:
+ * Change one byte of the record, it is written to the EEPROM later by LOCKOUT_tick().
+ */
+static void LOCKOUT_setRecord(uint8 offset, uint8 value)
+{
+	if(g_lockoutRecord[offset] != value)
+	{
+		g_lockoutRecord[offset] = value;
+		g_lockoutDirty |= (1 << offset);
+	}
+}
+
+/*
+ * Description:
+ * Start a lockout for the time of the current level.
+ */
+static void LOCKOUT_lock(void)
+{
+	g_lockoutTicksRemaining = (uint16)LOCKOUT_BASE_TICKS << g_lockoutRecord[LOCKOUT_LEVEL_OFFSET];
+}
+
+/*
+ * Description:
+ * Write one changed record byte to the EEPROM. Return TRUE if a byte is written.
+ */
+static uint8 LOCKOUT_writeNext(void)
+{
+	uint8 i, offset;
+
+	for(i = 0; i < LOCKOUT_EEPROM_RECORD_SIZE; i++)
+	{
+		offset = pgm_read_byte(&g_lockoutWriteOrder[i]);
+		if(g_lockoutDirty & (1 << offset))
+		{
+			/* A failed write stays dirty and is tried again on the next tick. */
+			if(EEPROM_writeByte(LOCKOUT_EEPROM_ADDRESS + offset, g_lockoutRecord[offset]) == SUCCESS)
+			{
+				g_lockoutDirty &= ~(1 << offset);
+			}
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description:
+ * Write all the changed record bytes to the EEPROM and wait for each one.
+ */
+static void LOCKOUT_save(void)
+{
+	uint8 i, offset;
+
+	for(i = 0; i < LOCKOUT_EEPROM_RECORD_SIZE; i++)
+	{
+		offset = pgm_read_byte(&g_lockoutWriteOrder[i]);
+		if(g_lockoutDirty & (1 << offset))
+		{
+			/* A failed write stays dirty and is tried again by LOCKOUT_tick(), the next bytes wait for it. */
+			if(EEPROM_writeByteWait(LOCKOUT_EEPROM_ADDRESS + offset, g_lockoutRecord[offset]) == ERROR)
+			{
+				return;
+			}
+			g_lockoutDirty &= ~(1 << offset);
+		}
+	}
+}
@@ -0,0 +1,99 @@
+ /******************************************************************************
+ *
+ * Module: LOCKOUT
+ *
+ * File Name: lockout.h
+ *
+ * Description: Header file for the wrong password lockout policy. The counters are kept in the
+ * 				external EEPROM, so a reset or a power cycle does not give the user new tries.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef LOCKOUT_H_
+#define LOCKOUT_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+#include "timer.h"
+
+/******************************************************************************
+ *									 Definitions							  *
+ ******************************************************************************/
+/*
+ * There is one password for all the doors, so there is one lockout for all of them: a wrong password on any
+ * door counts, and a locked ECU does not check passwords for any door.
+ */
+#define LOCKOUT_MAX_FAILURES				3			/* Wrong passwords in a row that lock the doors. */
+
+/*
+ * Each lockout is twice as long as the one before, until a correct password.
+ * 60 seconds, 2, 4, 8 then 16 minutes for all the next ones.
+ */
+#define LOCKOUT_BASE_TICKS					TIMER_MS_TO_TICKS(60000UL)	/* The first lockout is 60 seconds. */
+#define LOCKOUT_MAX_LEVEL					4			/* Maximum number of times the lockout time is doubled. */
+
+/*
+ * Record in the external EEPROM: failures, lockout level (lockouts since the last correct password)
+ * and locked flag.
+ * Starts after the old plain password (0x0300 to 0x0303).
+ */
+#define LOCKOUT_EEPROM_ADDRESS				0x0310
+#define LOCKOUT_EEPROM_RECORD_SIZE			3
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Read the counters from the EEPROM. A lockout that was running at the reset starts again
+ * for the full time of its level. Must be called after I2C_init().
+ */
+void LOCKOUT_init(void);
+
+/*
+ * Description:
+ * Clear the failures, the lockout level and the lock in the EEPROM and wait for it (factory reset).
+ * Must be called after I2C_init() and before LOCKOUT_init().
+ */
+void LOCKOUT_erase(void);
+
+/*
+ * Description:
+ * Return TRUE if passwords are not accepted now.
+ */
+uint8 LOCKOUT_isLocked(void);
+
+/*
+ * Description:
+ * Count a wrong password and save it in the EEPROM before returning, so the answer to MC1 is sent after
+ * the failure is kept: turning the power off after a wrong password does not give a new try.
+ * Return TRUE if this failure started a lockout.
+ */
+uint8 LOCKOUT_recordFailure(void);
+
+/*
+ * Description:
+ * A correct password: clear the failures and the lockout level.
+ */
+void LOCKOUT_recordSuccess(void);
+
+/*
+ * Description:
+ * Return the seconds left before passwords are accepted again, zero if there is no lockout.
+ */
+uint16 LOCKOUT_getRemainingSeconds(void);
+
+/*
+ * Description:
+ * Count down the lockout and write the changed counters to the EEPROM, one byte each tick.
+ * The EEPROM write cycle (10 ms) ends before the next tick, so nothing waits for the EEPROM.
+ * Must be called from the main loop for every timer tick.
+ * Return TRUE if a byte is written to the EEPROM on this tick.
+ */
+uint8 LOCKOUT_tick(void);
+
+#endif /* LOCKOUT_H_ */
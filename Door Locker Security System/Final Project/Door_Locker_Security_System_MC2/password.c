@@ -0,0 +1,364 @@
+ /******************************************************************************
+ *
+ * Module: PASSWORD
+ *
+ * File Name: password.c
+ *
+ * Description: Source file for the password storage
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "password.h"
+#include "external_eeprom.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define PASSWORD_OLD_SIZE					4			/* Bytes of the plain password of the old versions. */
+#define PASSWORD_ERASED_BYTE				0xFF		/* Value of an EEPROM byte that was never written, also the sequence of an empty slot. */
+
+#define PASSWORD_SLOT_ADDRESS(slot)			(PASSWORD_EEPROM_ADDRESS + ((uint16)(slot) * PASSWORD_SLOT_SIZE))
+#define PASSWORD_SEQUENCE_OFFSET			PASSWORD_RECORD_SIZE	/* The sequence byte follows the record in the slot. */
+
+/* Steps of PASSWORD_tick(): erase the sequence byte, write the record, write the sequence byte, erase the old password */
+#define PASSWORD_WRITE_RECORD				1
+#define PASSWORD_WRITE_SEQUENCE				(PASSWORD_WRITE_RECORD + PASSWORD_RECORD_SIZE)
+#define PASSWORD_WRITE_OLD					(PASSWORD_WRITE_SEQUENCE + 1)
+#define PASSWORD_WRITE_DONE					(PASSWORD_WRITE_OLD + PASSWORD_OLD_SIZE)
+
+#if(PASSWORD_RECORD_SIZE >= PASSWORD_SLOT_SIZE)
+#error "The record and its sequence byte must fit in PASSWORD_SLOT_SIZE"
+#endif
+
+#if (PASSWORD_BENCHMARK == TRUE)
+#define PASSWORD_STACK_FILL					0xA5		/* Fill value of the free SRAM for the stack measurement. */
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_passwordRecord[PASSWORD_RECORD_SIZE];				/* Salt then hash of the saved password, the same as its slot. */
+static uint8 g_passwordSlot = 0;									/* Slot of the record, the one read at start-up or being written. */
+static uint8 g_passwordSequence = PASSWORD_ERASED_BYTE;			/* Sequence byte of the record, 0 to 0xFE. */
+static uint8 g_passwordWriteIndex = PASSWORD_WRITE_DONE;			/* Next step of PASSWORD_tick(), PASSWORD_WRITE_DONE if nothing. */
+static uint8 g_passwordSaved = FALSE;								/* TRUE if the record holds a password. */
+
+#if (PASSWORD_BENCHMARK == TRUE)
+extern uint8 __heap_start;											/* First byte after the static variables (avr-libc linker script). */
+#endif
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Hash the password with the salt of the record.
+ */
+static void PASSWORD_hash(const uint8 *a_password_ptr, uint8 *a_digest_ptr);
+
+/*
+ * Description:
+ * Return the sequence byte of the slot written after the one with the given sequence (0xFE is followed by 0).
+ */
+static uint8 PASSWORD_nextSequence(uint8 sequence);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Read the salt and the hash of the saved password from the newest complete slot of the EEPROM.
+ * Must be called after I2C_init(). A plain password of the old versions is hashed and saved in a slot.
+ */
+void PASSWORD_init(void)
+{
+	uint8 sequence[PASSWORD_SLOT_COUNT];
+	uint8 oldPassword[PASSWORD_OLD_SIZE];
+	uint8 oldSaved = FALSE;
+	uint8 i;
+
+	/* A slot is complete when its sequence byte is written, it is erased before the other bytes are changed. */
+	for(i = 0; i < PASSWORD_SLOT_COUNT; i++)
+	{
+		EEPROM_readByte(PASSWORD_SLOT_ADDRESS(i) + PASSWORD_SEQUENCE_OFFSET, &sequence[i]);
+	}
+
+	g_passwordSaved = TRUE;
+	g_passwordWriteIndex = PASSWORD_WRITE_DONE;
+	if((sequence[0] == PASSWORD_ERASED_BYTE) && (sequence[1] == PASSWORD_ERASED_BYTE))
+	{
+		g_passwordSaved = FALSE;
+		g_passwordSlot = 0;
+	}
+	else if(sequence[0] == PASSWORD_ERASED_BYTE)
+	{
+		g_passwordSlot = 1;
+	}
+	else if(sequence[1] == PASSWORD_ERASED_BYTE)
+	{
+		g_passwordSlot = 0;
+	}
+	else
+	{
+		/* Both are complete: slot 1 is the newer one only if it was written after slot 0. */
+		g_passwordSlot = (sequence[1] == PASSWORD_nextSequence(sequence[0])) ? 1 : 0;
+	}
+
+	if(g_passwordSaved)
+	{
+		g_passwordSequence = sequence[g_passwordSlot];
+		for(i = 0; i < PASSWORD_RECORD_SIZE; i++)
+		{
+			EEPROM_readByte(PASSWORD_SLOT_ADDRESS(g_passwordSlot) + i, &g_passwordRecord[i]);
+		}
+		return;
+	}
+
+	/* No record yet: keep the password of an old version, so the device does not accept a new first password. */
+	for(i = 0; i < PASSWORD_OLD_SIZE; i++)
+	{
+		EEPROM_readByte(PASSWORD_OLD_EEPROM_ADDRESS + i, &oldPassword[i]);
+		if(oldPassword[i] != PASSWORD_ERASED_BYTE)
+		{
+			oldSaved = TRUE;
+		}
+	}
+	if(oldSaved)
+	{
+		PASSWORD_saveMemory(oldPassword);
+	}
+}
+
+/*
+ * Description:
+ * Erase both slots and the plain password of the old versions, and wait for the EEPROM (factory reset).
+ * Must be called after I2C_init() and before PASSWORD_init(), which then finds no password.
+ */
+void PASSWORD_erase(void)
+{
+	uint8 i;
+
+	/* A slot without its sequence byte is not complete, so it is not read. */
+	for(i = 0; i < PASSWORD_SLOT_COUNT; i++)
+	{
+		EEPROM_writeByteWait(PASSWORD_SLOT_ADDRESS(i) + PASSWORD_SEQUENCE_OFFSET, PASSWORD_ERASED_BYTE);
+	}
+	for(i = 0; i < PASSWORD_OLD_SIZE; i++)
+	{
+		EEPROM_writeByteWait(PASSWORD_OLD_EEPROM_ADDRESS + i, PASSWORD_ERASED_BYTE);
+	}
+}
+
+/*
+ * Description:
+ * Return TRUE if a password is saved. An erased record (all 0xFF) means the device has no password yet.
+ */
+uint8 PASSWORD_isSaved(void)
+{
+	return g_passwordSaved;
+}
+
+/*
+ * Description:
+ * Save a new password: make a new salt and hash the password with it.
+ * The record is written to the EEPROM later by PASSWORD_tick(), the new password is used directly.
+ */
+void PASSWORD_saveMemory(const uint8 *a_password_ptr)
+{
+	SHA256_ContextType context;
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 timers[4];
+	uint8 i;
+
+	/*
+	 * The salt only has to be different for each password, it is not secret.
+	 * It is the hash of the old salt and of the free running timers at the time the password is received.
+	 */
+	timers[0] = TCNT0;
+	timers[1] = TCNT1L;
+	timers[2] = TCNT1H;
+	timers[3] = TCNT2;
+	SHA256_init(&context);
+	SHA256_update(&context, g_passwordRecord, PASSWORD_SALT_SIZE);
+	SHA256_update(&context, timers, sizeof(timers));
+	SHA256_final(&context, digest);
+	for(i = 0; i < PASSWORD_SALT_SIZE; i++)
+	{
+		g_passwordRecord[i] = digest[i];
+	}
+
+	PASSWORD_hash(a_password_ptr, &g_passwordRecord[PASSWORD_SALT_SIZE]);
+
+	/*
+	 * The saved slot stays as it is, the new record goes to the other one. A record whose sequence byte
+	 * is not written yet is not saved, so it is written again in the same slot.
+	 */
+	if(g_passwordWriteIndex > PASSWORD_WRITE_SEQUENCE)
+	{
+		if(g_passwordSaved)
+		{
+			g_passwordSlot ^= 1;
+			g_passwordSequence = PASSWORD_nextSequence(g_passwordSequence);
+		}
+		else
+		{
+			g_passwordSequence = 0;
+		}
+	}
+	g_passwordWriteIndex = 0;
+	g_passwordSaved = TRUE;
+}
+
+/*
+ * Description:
+ * Hash the received password with the saved salt and compare it with the saved hash.
+ * The time does not depend on the password or on the place of the first different byte.
+ * Return TRUE if the password is correct.
+ */
+uint8 PASSWORD_compareFromMemory(const uint8 *a_password_ptr)
+{
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 difference = 0;
+	uint8 i;
+
+	PASSWORD_hash(a_password_ptr, digest);
+
+	/* All the bytes are compared, the differences are only collected. */
+	for(i = 0; i < SHA256_DIGEST_SIZE; i++)
+	{
+		difference |= digest[i] ^ g_passwordRecord[PASSWORD_SALT_SIZE + i];
+	}
+	return (difference == 0);
+}
+
+/*
+ * Description:
+ * Write one byte of a new slot to the EEPROM: the old sequence byte is erased, then the record is written,
+ * then the new sequence byte. Must be called from the main loop for a timer tick in which no other byte
+ * is written to the EEPROM (the EEPROM is busy for 10 ms after each byte).
+ */
+void PASSWORD_tick(void)
+{
+	uint16 slotAddress = PASSWORD_SLOT_ADDRESS(g_passwordSlot);
+	uint8 index = g_passwordWriteIndex;
+	uint8 result;
+
+	if(index >= PASSWORD_WRITE_DONE)
+	{
+		return;
+	}
+
+	/* The slot is not complete from the first step until the last byte of the record is written. */
+	if(index < PASSWORD_WRITE_RECORD)
+	{
+		result = EEPROM_writeByte(slotAddress + PASSWORD_SEQUENCE_OFFSET, PASSWORD_ERASED_BYTE);
+	}
+	else if(index < PASSWORD_WRITE_SEQUENCE)
+	{
+		result = EEPROM_writeByte(slotAddress + (index - PASSWORD_WRITE_RECORD), g_passwordRecord[index - PASSWORD_WRITE_RECORD]);
+	}
+	else if(index == PASSWORD_WRITE_SEQUENCE)
+	{
+		result = EEPROM_writeByte(slotAddress + PASSWORD_SEQUENCE_OFFSET, g_passwordSequence);
+	}
+	else
+	{
+		/* The new password is saved, the plain password of the old versions is erased. */
+		result = EEPROM_writeByte(PASSWORD_OLD_EEPROM_ADDRESS + (index - PASSWORD_WRITE_OLD), PASSWORD_ERASED_BYTE);
+	}
+
+	/* A failed write is tried again on the next tick. */
+	if(result == SUCCESS)
+	{
+		g_passwordWriteIndex++;
+	}
+}
+
+/*
+ * Description:
+ * Hash the password with the salt of the record.
+ */
+static void PASSWORD_hash(const uint8 *a_password_ptr, uint8 *a_digest_ptr)
+{
+	SHA256_ContextType context;
+	uint8 i;
+
+	SHA256_init(&context);
+	SHA256_update(&context, g_passwordRecord, PASSWORD_SALT_SIZE);
+	SHA256_update(&context, a_password_ptr, PASSWORD_SIZE);
+	SHA256_final(&context, a_digest_ptr);
+
+	/* Each extra hash costs the same time for every guess, the salt keeps the chain different for each device. */
+	for(i = 0; i < PASSWORD_HASH_ITERATIONS; i++)
+	{
+		SHA256_init(&context);
+		SHA256_update(&context, a_digest_ptr, SHA256_DIGEST_SIZE);
+		SHA256_update(&context, g_passwordRecord, PASSWORD_SALT_SIZE);
+		SHA256_final(&context, a_digest_ptr);
+	}
+}
+
+/*
+ * Description:
+ * Return the sequence byte of the slot written after the one with the given sequence (0xFE is followed by 0).
+ */
+static uint8 PASSWORD_nextSequence(uint8 sequence)
+{
+	return (uint8)((sequence + 1) % PASSWORD_ERASED_BYTE);
+}
+
+#if (PASSWORD_BENCHMARK == TRUE)
+/*
+ * Description:
+ * Measure the time of one SHA-256 block and of one password check in CPU cycles, and the SRAM
+ * never reached by the stack during them.
+ * Timer1 is used as a cycle counter and the free SRAM is overwritten, so it must be called at start-up
+ * with the interrupts disabled, before the buzzer and the motors configure Timer1.
+ */
+void PASSWORD_benchmark(PASSWORD_BenchmarkType *a_result_ptr)
+{
+	SHA256_ContextType context;
+	uint8 data[55] = {0};
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 oldTCCR1A = TCCR1A;
+	uint8 oldTCCR1B = TCCR1B;
+	uint8 *byte_ptr;
+
+	/* Fill the free SRAM below this function with a known value, the stack of the check overwrites what it uses. */
+	for(byte_ptr = &__heap_start; byte_ptr < (uint8 *)SP; byte_ptr++)
+	{
+		*byte_ptr = PASSWORD_STACK_FILL;
+	}
+
+	/* Normal mode, F_CPU/8: one count each 8 cycles, 524288 cycles before overflow. */
+	TCCR1A = 0;
+	TCCR1B = (1<<CS11);
+	TCNT1 = 0;
+	SHA256_init(&context);
+	SHA256_update(&context, data, sizeof(data));
+	SHA256_final(&context, digest);
+	a_result_ptr->blockCycles = (uint32)TCNT1 * 8;
+
+	/* F_CPU/64: one count each 64 cycles, 4194304 cycles before overflow. */
+	TCCR1B = (1<<CS11) | (1<<CS10);
+	TCNT1 = 0;
+	PASSWORD_compareFromMemory(data);
+	a_result_ptr->verifyCycles = (uint32)TCNT1 * 64;
+
+	/* The bytes still holding the fill value were never used. */
+	for(byte_ptr = &__heap_start; (byte_ptr < (uint8 *)SP) && (*byte_ptr == PASSWORD_STACK_FILL); byte_ptr++)
+	{
+	}
+	a_result_ptr->stackFreeBytes = (uint16)(byte_ptr - &__heap_start);
+
+	TCNT1 = 0;
+	TCCR1A = oldTCCR1A;
+	TCCR1B = oldTCCR1B;
+}
+#endif
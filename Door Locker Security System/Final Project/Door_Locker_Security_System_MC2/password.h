@@ -0,0 +1,128 @@
+ /******************************************************************************
+ *
+ * Module: PASSWORD
+ *
+ * File Name: password.h
+ *
+ * Description: Header file for the password storage. Only a salted SHA-256 hash of the password is
+ * 				kept in the external EEPROM, so reading the EEPROM does not give the password.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef PASSWORD_H_
+#define PASSWORD_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+#include "sha256.h"
+
+/******************************************************************************
+ *									 Definitions							  *
+ ******************************************************************************/
+#define PASSWORD_SIZE						4	 		/* To set the password size with a name. */
+#define PASSWORD_SALT_SIZE					16			/* Random bytes hashed with the password, different for each saved password. */
+
+/*
+ * hash = SHA-256(salt, password), then hash = SHA-256(hash, salt) PASSWORD_HASH_ITERATIONS times.
+ * Each hash is one SHA-256 block, about 60000 cycles (7.5 ms at 8 MHz), so a check is about 9 blocks = 68 ms,
+ * below the 100 ms budget of the answer to MC1.
+ * The iterations add little against a dump of the EEPROM: 10^4 passwords * 9 blocks is still a few seconds
+ * on a PC. The passwords are protected by the lockout of the tries, the hash only keeps the password unreadable.
+ */
+#define PASSWORD_HASH_ITERATIONS			8
+
+/*
+ * Two slots in the external EEPROM, each one is a record (salt then hash) then a sequence byte written last.
+ * A new password is written to the slot that does not hold the saved one, so a reset while it is written
+ * keeps the saved password. PASSWORD_init() takes the complete slot with the newest sequence.
+ * Starts after the lockout record (0x0310 to 0x0312), slot 0 at 0x0320 and slot 1 at 0x0360.
+ */
+#define PASSWORD_EEPROM_ADDRESS				0x0320
+#define PASSWORD_RECORD_SIZE				(PASSWORD_SALT_SIZE + SHA256_DIGEST_SIZE)
+#define PASSWORD_SLOT_SIZE					0x40		/* Record and sequence byte, rounded up to a multiple of the EEPROM page. */
+#define PASSWORD_SLOT_COUNT					2
+
+/*
+ * With TRUE, PASSWORD_benchmark() measures the hash time with Timer1 and the stack left free by the check
+ * at start-up. The result is read with the debugger, it is not needed by the application.
+ */
+#define PASSWORD_BENCHMARK					FALSE
+
+/* Place of the plain password of the old versions, hashed by PASSWORD_init() then erased. */
+#define PASSWORD_OLD_EEPROM_ADDRESS			0x0300
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+#if (PASSWORD_BENCHMARK == TRUE)
+/* CPU cycles measured by PASSWORD_benchmark() */
+typedef struct
+{
+	uint32 blockCycles;					/* One SHA-256 block (message of 55 bytes). */
+	uint32 verifyCycles;				/* One call of PASSWORD_compareFromMemory(). */
+	uint16 stackFreeBytes;				/* SRAM between the static variables and the deepest stack of the check. */
+}PASSWORD_BenchmarkType;
+#endif
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Read the salt and the hash of the saved password from the newest complete slot of the EEPROM.
+ * Must be called after I2C_init(). A plain password of the old versions is hashed and saved in a slot.
+ */
+void PASSWORD_init(void);
+
+/*
+ * Description:
+ * Erase both slots and the plain password of the old versions, and wait for the EEPROM (factory reset).
+ * Must be called after I2C_init() and before PASSWORD_init(), which then finds no password.
+ */
+void PASSWORD_erase(void);
+
+/*
+ * Description:
+ * Return TRUE if a password is saved. No complete slot means the device has no password yet.
+ */
+uint8 PASSWORD_isSaved(void);
+
+/*
+ * Description:
+ * Save a new password: make a new salt and hash the password with it.
+ * The record is written to the EEPROM later by PASSWORD_tick(), the new password is used directly.
+ */
+void PASSWORD_saveMemory(const uint8 *a_password_ptr);
+
+/*
+ * Description:
+ * Hash the received password with the saved salt and compare it with the saved hash.
+ * The time does not depend on the password or on the place of the first different byte.
+ * Return TRUE if the password is correct.
+ */
+uint8 PASSWORD_compareFromMemory(const uint8 *a_password_ptr);
+
+/*
+ * Description:
+ * Write one byte of a new slot to the EEPROM: the old sequence byte is erased, then the record is written,
+ * then the new sequence byte. Must be called from the main loop for a timer tick in which no other byte
+ * is written to the EEPROM (the EEPROM is busy for 10 ms after each byte).
+ */
+void PASSWORD_tick(void);
+
+#if (PASSWORD_BENCHMARK == TRUE)
+/*
+ * Description:
+ * Measure the time of one SHA-256 block and of one password check in CPU cycles, and the SRAM
+ * never reached by the stack during them.
+ * Timer1 is used as a cycle counter and the free SRAM is overwritten, so it must be called at start-up
+ * with the interrupts disabled, before the buzzer and the motors configure Timer1.
+ */
+void PASSWORD_benchmark(PASSWORD_BenchmarkType *a_result_ptr);
+#endif
+
+#endif /* PASSWORD_H_ */
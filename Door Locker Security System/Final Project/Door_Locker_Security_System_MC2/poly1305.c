@@ -0,0 +1,197 @@
+/****************************************************************************************
+ *
+ * Module: Poly1305
+ *
+ * File Name: poly1305.c
+ *
+ * Discretion: Source file for the Poly1305 one-time authenticator (RFC 8439)
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "poly1305.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*
+ * The numbers modulo p = 2^130 - 5 are kept as 17 bytes (136 bits), least significant first.
+ * The AVR multiplies 8 x 8 bits in one instruction, so a block costs 289 of these multiplications.
+ */
+#define POLY1305_LIMBS					17
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * h = h + c, the bytes of h are carried.
+ */
+static void POLY1305_add(uint8 *a_h_ptr, const uint8 *a_c_ptr);
+
+/*
+ * Description:
+ * h = h * r mod p, partly reduced (h stays below 2^131).
+ */
+static void POLY1305_multiply(uint8 *a_h_ptr, const uint8 *a_r_ptr);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Write the 16 bytes tag of the message. The key must be used for one message only.
+ */
+void POLY1305_mac(const uint8 *a_key_ptr, const uint8 *a_message_ptr, uint8 length, uint8 *a_tag_ptr)
+{
+	uint8 r[POLY1305_LIMBS];
+	uint8 h[POLY1305_LIMBS];
+	uint8 c[POLY1305_LIMBS];
+	uint8 g[POLY1305_LIMBS];
+	uint8 i, mask;
+
+	/* r is the first half of the key with the bits cleared as the RFC requires. */
+	for(i = 0; i < 16; i++)
+	{
+		r[i] = a_key_ptr[i];
+		h[i] = 0;
+	}
+	r[16] = 0;
+	h[16] = 0;
+	r[3] &= 15; r[7] &= 15; r[11] &= 15; r[15] &= 15;
+	r[4] &= 252; r[8] &= 252; r[12] &= 252;
+
+	/* Each block of 16 bytes with a one byte after it, the last block may be shorter. */
+	while(length != 0)
+	{
+		for(i = 0; (i < 16) && (i < length); i++)
+		{
+			c[i] = a_message_ptr[i];
+		}
+		a_message_ptr += i;
+		length -= i;
+		c[i] = 1;
+		for(i++; i < POLY1305_LIMBS; i++)
+		{
+			c[i] = 0;
+		}
+
+		POLY1305_add(h, c);
+		POLY1305_multiply(h, r);
+	}
+
+	/* Full reduction: take h - p if it is not negative. The choice is made by a mask, not a branch. */
+	for(i = 0; i < POLY1305_LIMBS; i++)
+	{
+		g[i] = h[i];
+		c[i] = 0;
+	}
+	c[0] = 5;
+	c[16] = 252;						/* -p = 5 - 2^130 in 17 bytes. */
+	POLY1305_add(g, c);
+	mask = (uint8)((g[16] >> 7) - 1);	/* 0xFF if g = h - p is not negative. */
+	for(i = 0; i < POLY1305_LIMBS; i++)
+	{
+		h[i] ^= mask & (g[i] ^ h[i]);
+	}
+
+	/* tag = (h + s) mod 2^128, s is the second half of the key. */
+	for(i = 0; i < 16; i++)
+	{
+		c[i] = a_key_ptr[i + 16];
+	}
+	c[16] = 0;
+	POLY1305_add(h, c);
+	for(i = 0; i < POLY1305_TAG_SIZE; i++)
+	{
+		a_tag_ptr[i] = h[i];
+	}
+}
+
+/*
+ * Description:
+ * Compare two tags. The time does not depend on the place of the first different byte.
+ * Return TRUE if they are equal.
+ */
+uint8 POLY1305_verify(const uint8 *a_tag1_ptr, const uint8 *a_tag2_ptr)
+{
+	uint8 difference = 0;
+	uint8 i;
+
+	for(i = 0; i < POLY1305_TAG_SIZE; i++)
+	{
+		difference |= a_tag1_ptr[i] ^ a_tag2_ptr[i];
+	}
+	return (difference == 0);
+}
+
+/*
+ * Description:
+ * h = h + c, the bytes of h are carried.
+ */
+static void POLY1305_add(uint8 *a_h_ptr, const uint8 *a_c_ptr)
+{
+	uint16 u = 0;
+	uint8 i;
+
+	for(i = 0; i < POLY1305_LIMBS; i++)
+	{
+		u += (uint16)a_h_ptr[i] + a_c_ptr[i];
+		a_h_ptr[i] = (uint8)u;
+		u >>= 8;
+	}
+}
+
+/*
+ * Description:
+ * h = h * r mod p, partly reduced (h stays below 2^131).
+ */
+static void POLY1305_multiply(uint8 *a_h_ptr, const uint8 *a_r_ptr)
+{
+	uint32 x[POLY1305_LIMBS];
+	uint32 low, high;
+	uint32 u;
+	uint8 i, j;
+
+	/*
+	 * 2^136 = 2^6 * 2^130 = 320 mod p, so the products above the 17 bytes come back multiplied by 320.
+	 * They are added apart and multiplied once for each byte, so every product is only 8 x 8 bits.
+	 */
+	for(i = 0; i < POLY1305_LIMBS; i++)
+	{
+		low = 0;
+		high = 0;
+		for(j = 0; j <= i; j++)
+		{
+			low += (uint16)((uint16)a_h_ptr[j] * a_r_ptr[i - j]);
+		}
+		for(; j < POLY1305_LIMBS; j++)
+		{
+			high += (uint16)((uint16)a_h_ptr[j] * a_r_ptr[i + POLY1305_LIMBS - j]);
+		}
+		x[i] = low + (high << 8) + (high << 6);
+	}
+
+	/* Carry the bytes, the bits above 2^130 come back multiplied by 5. */
+	u = 0;
+	for(i = 0; i < 16; i++)
+	{
+		u += x[i];
+		a_h_ptr[i] = (uint8)u;
+		u >>= 8;
+	}
+	u += x[16];
+	a_h_ptr[16] = (uint8)(u & 3);
+	u = 5 * (u >> 2);
+	for(i = 0; i < 16; i++)
+	{
+		u += a_h_ptr[i];
+		a_h_ptr[i] = (uint8)u;
+		u >>= 8;
+	}
+	a_h_ptr[16] += (uint8)u;
+}
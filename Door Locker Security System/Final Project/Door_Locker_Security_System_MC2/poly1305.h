@@ -0,0 +1,43 @@
+/****************************************************************************************
+ *
+ * Module: Poly1305
+ *
+ * File Name: poly1305.h
+ *
+ * Discretion: Header file for the Poly1305 one-time authenticator (RFC 8439)
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef POLY1305_H_
+#define POLY1305_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define POLY1305_KEY_SIZE				32			/* Bytes of the one-time key. */
+#define POLY1305_TAG_SIZE				16			/* Bytes of the tag. */
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Write the 16 bytes tag of the message. The key must be used for one message only.
+ */
+void POLY1305_mac(const uint8 *a_key_ptr, const uint8 *a_message_ptr, uint8 length, uint8 *a_tag_ptr);
+
+/*
+ * Description:
+ * Compare two tags. The time does not depend on the place of the first different byte.
+ * Return TRUE if they are equal.
+ */
+uint8 POLY1305_verify(const uint8 *a_tag1_ptr, const uint8 *a_tag2_ptr);
+
+#endif /* POLY1305_H_ */
@@ -16,25 +16,150 @@
 #include "pwm.h"
 #include <avr/io.h>
 #include "gpio.h"
+#include "sync.h"
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Global variables to hold the address of the call back function in the application */
+static void (*volatile g_pwmCallBackPtr)(void) = NULL_PTR;
+
+/* CS12:0 value of each PWM_PrescalerType for Timer1 */
+static const uint8 g_pwmTimer1Clock[] PROGMEM = {0, 1, 2, 3, 3, 4, 4, 5};
 
 /*******************************************************************************
  *                    	    Functions Declaration                              *
  *******************************************************************************/
 /*
  * Description:
- * Generate PWM with wanted speed percentage.
+ * Start the timer of the channel in 8-bit fast PWM mode (non-inverting) with 0% duty cycle.
+ * Must be called once for each channel, the duty cycle is then changed by PWM_setDuty() without restarting the timer.
+ * OC1A and OC1B share Timer1, so they have the same frequency (the prescaler of the last call).
+ */
+void PWM_init(PWM_ChannelType channel, PWM_PrescalerType prescaler)
+{
+	if(channel == PWM_CHANNEL_OC2)
+	{
+		TCNT2 = 0; /* Initial value */
+
+		OCR2 = 0; /* Start with the output low */
+
+		GPIO_setupPinDirectionFast(PWM_OC2_PORT_ID, PWM_OC2_PIN_ID, PIN_OUTPUT);
+		/*
+		 * FOC2 = 0 (because PWM is is used)
+		 * WGM21 = 1, WGM20 = 1 (Fast PWM)
+		 * COM20 = 0, COM21 = 1 (Non-inveting mode)
+		 * CS22:0 = prescaler
+		 */
+		TCCR2 = (1<<WGM21) | (1<<WGM20) | (1<<COM21) | ((prescaler & 0x07)<<CS20);
+	}
+	else if(channel == PWM_CHANNEL_OC1B)
+	{
+		TCNT1 = 0; /* Initial value */
+
+		OCR1B = 0; /* Start with the output low */
+
+		GPIO_setupPinDirectionFast(PWM_OC1B_PORT_ID, PWM_OC1B_PIN_ID, PIN_OUTPUT);
+		/*
+		 * WGM13:0 = 0101 (Fast PWM 8-bit, TOP = 0xFF)
+		 * COM1B1 = 1, COM1B0 = 0 (Non-inveting mode on OC1B), OC1A is not changed
+		 * CS12:0 = prescaler
+		 */
+		TCCR1A = (TCCR1A & 0xC0) | (1<<COM1B1) | (1<<WGM10);
+		TCCR1B = (1<<WGM12) | (pgm_read_byte(&g_pwmTimer1Clock[prescaler & 0x07])<<CS10);
+	}
+	else
+	{
+		TCNT1 = 0; /* Initial value */
+
+		OCR1A = 0; /* Start with the output low */
+
+		GPIO_setupPinDirectionFast(PWM_OC1A_PORT_ID, PWM_OC1A_PIN_ID, PIN_OUTPUT);
+		/*
+		 * WGM13:0 = 0101 (Fast PWM 8-bit, TOP = 0xFF)
+		 * COM1A1 = 1, COM1A0 = 0 (Non-inveting mode on OC1A), OC1B is not changed
+		 * CS12:0 = prescaler
+		 */
+		TCCR1A = (TCCR1A & 0x30) | (1<<COM1A1) | (1<<WGM10);
+		TCCR1B = (1<<WGM12) | (pgm_read_byte(&g_pwmTimer1Clock[prescaler & 0x07])<<CS10);
+	}
+}
+
+/*
+ * Description:
+ * Change the duty cycle of the channel (percentage from 0 to 100, bigger values are taken as 100).
+ * The timer is not restarted. The compare registers are double buffered in fast PWM mode, so the new value
+ * starts with the next PWM period and no period is cut.
+ */
+void PWM_setDuty(PWM_ChannelType channel, uint8 duty_cycle)
+{
+	if(duty_cycle > PWM_MAX_DUTY)
+	{
+		duty_cycle = PWM_MAX_DUTY;
+	}
+	PWM_setCompare(channel, PWM_DUTY_TO_COMPARE(duty_cycle));
+}
+
+/*
+ * Description:
+ * Same as PWM_setDuty() with the compare value directly (0 to 255).
  */
-void PWM_Timer2_init(uint8 duty_cycle)
+void PWM_setCompare(PWM_ChannelType channel, uint8 compare_value)
 {
-	TCNT2 = 0; /* Initial value */
+	uint8 sreg;
 
-	OCR2 = 255 * (duty_cycle * 0.01); /* Set Compare value */
+	/* Set Compare value */
+	if(channel == PWM_CHANNEL_OC2)
+	{
+		OCR2 = compare_value;
+		return;
+	}
 
-	DDRB = DDRB | (1<<EN_PIN_ID);
-	/*
-	 * FOC0 = 0 (because PWM is is used)
-	 * COM00 = 0, COM01 = 1 (Non-inveting mode)
-	 * CS00 =0 CS01 = 1 CS02 = 0 (F_CPU/8)
-	 */
-	TCCR2 = (1<<WGM21) | (1<<WGM20) | (1<<COM21) | (1<<CS21);
+	/* 16-bit write through the TEMP register shared by OCR1A and OCR1B, an ISR must not write the other one in the middle */
+	sreg = SYNC_enterCritical();
+	if(channel == PWM_CHANNEL_OC1B)
+	{
+		OCR1B = compare_value;
+	}
+	else
+	{
+		OCR1A = compare_value;
+	}
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Call the function from the Timer2 overflow ISR at the start of each PWM period (F_CPU / (prescaler * 256)).
+ * NULL_PTR disables the overflow interrupt.
+ */
+void PWM_setOverflowCallBack(void(*a_ptr)(void))
+{
+	uint8 sreg = SYNC_enterCritical();
+
+	g_pwmCallBackPtr = a_ptr;
+	if(a_ptr == NULL_PTR)
+	{
+		TIMSK &= ~(1<<TOIE2);
+	}
+	else
+	{
+		TIFR = (1<<TOV2);	/* Clear the old flag by writing one */
+		TIMSK |= (1<<TOIE2);
+	}
+	SYNC_exitCritical(sreg);
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(TIMER2_OVF_vect)
+{
+	if(g_pwmCallBackPtr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application at the start of the PWM period */
+		(*g_pwmCallBackPtr)();
+	}
 }
@@ -21,15 +21,69 @@
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
-#define EN_PIN_ID			PIN3_ID
+/* Output pins of the PWM channels */
+#define PWM_OC2_PORT_ID		PORTD_ID
+#define PWM_OC2_PIN_ID		PIN7_ID
+#define PWM_OC1B_PORT_ID	PORTD_ID
+#define PWM_OC1B_PIN_ID		PIN4_ID
+#define PWM_OC1A_PORT_ID	PORTD_ID
+#define PWM_OC1A_PIN_ID		PIN5_ID
+
+#define PWM_MAX_DUTY		100			/* Duty cycle is a percentage from 0 to 100. */
+#define PWM_MAX_COMPARE		255			/* Compare value of 100% duty cycle (8-bit timer). */
+
+/*
+ * Convert a percentage to the compare value: percentage * 255 / 100 rounded.
+ * 255/100 is 653/256, so the conversion is one 8x16 hardware multiplication and a shift, no division.
+ * When the percentage is a constant, the compiler calculates it at compile time.
+ */
+#define PWM_DUTY_TO_COMPARE(duty)	((uint8)((((uint16)(duty) * 653u) + 128u) >> 8))
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* Timer clock, the PWM frequency is F_CPU / (prescaler * 256). Timer1 has no /32 and /128, they are taken as /64 and /256. */
+typedef enum
+{
+	PWM_NO_CLOCK, PWM_F_CPU_CLOCK, PWM_F_CPU_8, PWM_F_CPU_32, PWM_F_CPU_64, PWM_F_CPU_128, PWM_F_CPU_256, PWM_F_CPU_1024
+}PWM_PrescalerType;
+
+/* 8-bit PWM outputs: OC2 of Timer2, OC1B and OC1A of Timer1 (Timer0 is the system tick) */
+typedef enum
+{
+	PWM_CHANNEL_OC2, PWM_CHANNEL_OC1B, PWM_CHANNEL_OC1A
+}PWM_ChannelType;
 
 /*******************************************************************************
  *                    	  	 Functions Prototype       		                   *
  *******************************************************************************/
 /*
  * Description:
- * Generate PWM with wanted speed percentage.
+ * Start the timer of the channel in 8-bit fast PWM mode (non-inverting) with 0% duty cycle.
+ * Must be called once for each channel, the duty cycle is then changed by PWM_setDuty() without restarting the timer.
+ * OC1A and OC1B share Timer1, so they have the same frequency (the prescaler of the last call).
+ */
+void PWM_init(PWM_ChannelType channel, PWM_PrescalerType prescaler);
+
+/*
+ * Description:
+ * Change the duty cycle of the channel (percentage from 0 to 100, bigger values are taken as 100).
+ * The timer is not restarted. The compare registers are double buffered in fast PWM mode, so the new value
+ * starts with the next PWM period and no period is cut.
+ */
+void PWM_setDuty(PWM_ChannelType channel, uint8 duty_cycle);
+
+/*
+ * Description:
+ * Same as PWM_setDuty() with the compare value directly (0 to 255).
+ */
+void PWM_setCompare(PWM_ChannelType channel, uint8 compare_value);
+
+/*
+ * Description:
+ * Call the function from the Timer2 overflow ISR at the start of each PWM period (F_CPU / (prescaler * 256)).
+ * NULL_PTR disables the overflow interrupt.
  */
-void PWM_Timer2_init(uint8 duty_cycle);
+void PWM_setOverflowCallBack(void(*a_ptr)(void));
 
 #endif /* PWM_H_ */
@@ -0,0 +1,257 @@
+/****************************************************************************************
+ *
+ * Module: SHA256
+ *
+ * File Name: sha256.c
+ *
+ * Discretion: Source file for the SHA-256 hash (FIPS 180-4)
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "sha256.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SHA256_CH(x, y, z)				((z) ^ ((x) & ((y) ^ (z))))
+#define SHA256_MAJ(x, y, z)				(((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_SIGMA0(x)				(SHA256_rotr((x), 2) ^ SHA256_rotr((x), 13) ^ SHA256_rotr((x), 22))
+#define SHA256_SIGMA1(x)				(SHA256_rotr((x), 6) ^ SHA256_rotr((x), 11) ^ SHA256_rotr((x), 25))
+#define SHA256_GAMMA0(x)				(SHA256_rotr((x), 7) ^ SHA256_rotr((x), 18) ^ ((x) >> 3))
+#define SHA256_GAMMA1(x)				(SHA256_rotr((x), 17) ^ SHA256_rotr((x), 19) ^ ((x) >> 10))
+
+/*
+ * One round. The eight working words are not moved after each round, the next round takes them
+ * with new names, so eight rounds are one loop pass and the words stay in place.
+ * The message schedule keeps only the last 16 words (64 bytes of RAM instead of 256).
+ */
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, i)													\
+	do{																							\
+		uint32 t1;																				\
+		if((round + (i)) >= 16)																	\
+		{																						\
+			w[(i)] += SHA256_GAMMA1(w[((i) + 14) & 15]) + w[((i) + 9) & 15] + SHA256_GAMMA0(w[((i) + 1) & 15]);	\
+		}																						\
+		t1 = (h) + SHA256_SIGMA1(e) + SHA256_CH((e), (f), (g)) + pgm_read_dword(&g_sha256K[round + (i)]) + w[(i)];	\
+		(d) += t1;																				\
+		(h) = t1 + SHA256_SIGMA0(a) + SHA256_MAJ((a), (b), (c));								\
+	}while(0)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Round constants: first 32 bits of the fractional parts of the cube roots of the first 64 primes */
+static const uint32 g_sha256K[64] PROGMEM =
+{
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+/* Initial hash: first 32 bits of the fractional parts of the square roots of the first 8 primes */
+static const uint32 g_sha256Init[8] PROGMEM =
+{
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+/*******************************************************************************
+ *                    	     	Function Prototype 	                           *
+ *******************************************************************************/
+/*
+ * Description:
+ * Compress the full block in the buffer into the state.
+ */
+static void SHA256_compress(SHA256_ContextType *a_context_ptr);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Rotate right by a constant. The AVR has no barrel shifter and avr-gcc makes a 32-bit shift by n
+ * as a loop of n 1-bit shifts of 4 bytes, so a rotation would cost up to 32 of them.
+ * Here the whole bytes are moved (register moves only) and at most 3 single bit rotations are left:
+ * 13 = 16 - 3 is moved 2 bytes right and rotated 3 bits left.
+ */
+static inline __attribute__((always_inline)) uint32 SHA256_rotr(uint32 x, uint8 n)
+{
+	uint8 bytes = n >> 3;
+	uint8 bits = n & 7;
+	uint8 left = FALSE;
+
+	if(bits > 4)
+	{
+		bytes++;
+		bits = 8 - bits;
+		left = TRUE;
+	}
+
+	switch(bytes & 3)
+	{
+	case 1:
+		x = (x >> 8) | (x << 24);
+		break;
+	case 2:
+		x = (x >> 16) | (x << 16);
+		break;
+	case 3:
+		x = (x >> 24) | (x << 8);
+		break;
+	default:
+		break;
+	}
+
+	while(bits != 0)
+	{
+		x = left ? ((x << 1) | (x >> 31)) : ((x >> 1) | (x << 31));
+		bits--;
+	}
+	return x;
+}
+
+/*
+ * Description:
+ * Start a new hash.
+ */
+void SHA256_init(SHA256_ContextType *a_context_ptr)
+{
+	uint8 i;
+
+	for(i = 0; i < 8; i++)
+	{
+		a_context_ptr->state[i] = pgm_read_dword(&g_sha256Init[i]);
+	}
+	a_context_ptr->bufferLength = 0;
+	a_context_ptr->length = 0;
+}
+
+/*
+ * Description:
+ * Add bytes to the hash. Can be called many times, each complete block is compressed directly.
+ */
+void SHA256_update(SHA256_ContextType *a_context_ptr, const uint8 *a_data_ptr, uint16 length)
+{
+	a_context_ptr->length += length;
+	while(length != 0)
+	{
+		a_context_ptr->buffer[a_context_ptr->bufferLength] = *a_data_ptr;
+		a_context_ptr->bufferLength++;
+		a_data_ptr++;
+		length--;
+
+		if(a_context_ptr->bufferLength == SHA256_BLOCK_SIZE)
+		{
+			SHA256_compress(a_context_ptr);
+			a_context_ptr->bufferLength = 0;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Add the padding and write the 32 bytes of the hash. The context must be started again to be used.
+ */
+void SHA256_final(SHA256_ContextType *a_context_ptr, uint8 *a_digest_ptr)
+{
+	uint32 bits = a_context_ptr->length << 3;
+	uint8 i = a_context_ptr->bufferLength;
+
+	/* One bit after the message, then zeros up to the length in the last 8 bytes of a block. */
+	a_context_ptr->buffer[i++] = 0x80;
+	if(i > (SHA256_BLOCK_SIZE - 8))
+	{
+		while(i < SHA256_BLOCK_SIZE)
+		{
+			a_context_ptr->buffer[i++] = 0;
+		}
+		SHA256_compress(a_context_ptr);
+		i = 0;
+	}
+	while(i < (SHA256_BLOCK_SIZE - 4))
+	{
+		a_context_ptr->buffer[i++] = 0;
+	}
+
+	/* Length in bits, big endian (the high 32 bits are zero in the 60 bytes and above). */
+	a_context_ptr->buffer[60] = (uint8)(bits >> 24);
+	a_context_ptr->buffer[61] = (uint8)(bits >> 16);
+	a_context_ptr->buffer[62] = (uint8)(bits >> 8);
+	a_context_ptr->buffer[63] = (uint8)bits;
+	a_context_ptr->buffer[59] = (uint8)(a_context_ptr->length >> 29);
+	SHA256_compress(a_context_ptr);
+
+	/* The hash is the state, big endian. */
+	for(i = 0; i < SHA256_DIGEST_SIZE; i++)
+	{
+		a_digest_ptr[i] = (uint8)(a_context_ptr->state[i >> 2] >> (24 - ((i & 3) << 3)));
+	}
+}
+
+/*
+ * Description:
+ * Compress the full block in the buffer into the state.
+ */
+static void SHA256_compress(SHA256_ContextType *a_context_ptr)
+{
+	uint32 w[16];
+	uint32 a, b, c, d, e, f, g, h;
+	const uint8 *block = a_context_ptr->buffer;
+	uint8 round;
+
+	/* The block is big endian. */
+	for(round = 0; round < 16; round++)
+	{
+		w[round] = ((uint32)block[0] << 24) | ((uint32)block[1] << 16) | ((uint16)block[2] << 8) | block[3];
+		block += 4;
+	}
+
+	a = a_context_ptr->state[0];
+	b = a_context_ptr->state[1];
+	c = a_context_ptr->state[2];
+	d = a_context_ptr->state[3];
+	e = a_context_ptr->state[4];
+	f = a_context_ptr->state[5];
+	g = a_context_ptr->state[6];
+	h = a_context_ptr->state[7];
+
+	/* 64 rounds, 16 at each pass so w[] is indexed by constants. */
+	for(round = 0; round < 64; round += 16)
+	{
+		SHA256_ROUND(a, b, c, d, e, f, g, h, 0);
+		SHA256_ROUND(h, a, b, c, d, e, f, g, 1);
+		SHA256_ROUND(g, h, a, b, c, d, e, f, 2);
+		SHA256_ROUND(f, g, h, a, b, c, d, e, 3);
+		SHA256_ROUND(e, f, g, h, a, b, c, d, 4);
+		SHA256_ROUND(d, e, f, g, h, a, b, c, 5);
+		SHA256_ROUND(c, d, e, f, g, h, a, b, 6);
+		SHA256_ROUND(b, c, d, e, f, g, h, a, 7);
+		SHA256_ROUND(a, b, c, d, e, f, g, h, 8);
+		SHA256_ROUND(h, a, b, c, d, e, f, g, 9);
+		SHA256_ROUND(g, h, a, b, c, d, e, f, 10);
+		SHA256_ROUND(f, g, h, a, b, c, d, e, 11);
+		SHA256_ROUND(e, f, g, h, a, b, c, d, 12);
+		SHA256_ROUND(d, e, f, g, h, a, b, c, 13);
+		SHA256_ROUND(c, d, e, f, g, h, a, b, 14);
+		SHA256_ROUND(b, c, d, e, f, g, h, a, 15);
+	}
+
+	a_context_ptr->state[0] += a;
+	a_context_ptr->state[1] += b;
+	a_context_ptr->state[2] += c;
+	a_context_ptr->state[3] += d;
+	a_context_ptr->state[4] += e;
+	a_context_ptr->state[5] += f;
+	a_context_ptr->state[6] += g;
+	a_context_ptr->state[7] += h;
+}
@@ -0,0 +1,59 @@
+/****************************************************************************************
+ *
+ * Module: SHA256
+ *
+ * File Name: sha256.h
+ *
+ * Discretion: Header file for the SHA-256 hash (FIPS 180-4)
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+#define SHA256_DIGEST_SIZE				32			/* Bytes of the hash. */
+#define SHA256_BLOCK_SIZE				64			/* Bytes hashed by each compression. */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct
+{
+	uint32 state[8];							/* Hash of the blocks compressed so far. */
+	uint8 buffer[SHA256_BLOCK_SIZE];			/* Bytes of the block that is not complete yet. */
+	uint8 bufferLength;							/* Number of bytes in the buffer. */
+	uint32 length;								/* Number of bytes hashed (messages up to 4 GB). */
+}SHA256_ContextType;
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Start a new hash.
+ */
+void SHA256_init(SHA256_ContextType *a_context_ptr);
+
+/*
+ * Description:
+ * Add bytes to the hash. Can be called many times, each complete block is compressed directly.
+ */
+void SHA256_update(SHA256_ContextType *a_context_ptr, const uint8 *a_data_ptr, uint16 length);
+
+/*
+ * Description:
+ * Add the padding and write the 32 bytes of the hash. The context must be started again to be used.
+ */
+void SHA256_final(SHA256_ContextType *a_context_ptr, uint8 *a_digest_ptr);
+
+#endif /* SHA256_H_ */
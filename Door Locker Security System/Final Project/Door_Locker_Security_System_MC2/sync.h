@@ -0,0 +1,139 @@
+/****************************************************************************************
+ *
+ * Module: Sync
+ *
+ * File Name: sync.h
+ *
+ * Discretion: Primitives to share data between an ISR and the main loop safely at any
+ * 			   optimization level (critical sections, flags and multi-byte reads/writes).
+ *
+ * Author: Abdelrahman Ehab
+ *
+ ****************************************************************************************/
+
+#ifndef SYNC_H_
+#define SYNC_H_
+
+/*******************************************************************************
+ *                    	     	Include Header	                               *
+ *******************************************************************************/
+#include "std_types.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*
+ * Stop the compiler from moving memory accesses across this point.
+ * It does not generate any instruction.
+ */
+#define SYNC_BARRIER()				__asm__ __volatile__("" ::: "memory")
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/* A flag set by one side (usually the ISR) and taken by the other side (usually the main loop). */
+typedef volatile uint8 SYNC_Flag;
+
+/*******************************************************************************
+ *                         	Function Definitions                               *
+ *******************************************************************************/
+/*
+ * Description:
+ * Disable the interrupts and return the old value of SREG to be given to SYNC_exitCritical().
+ * Critical sections can be nested and can be used inside an ISR.
+ */
+static inline uint8 SYNC_enterCritical(void)
+{
+	uint8 sreg = SREG;
+
+	cli();
+	SYNC_BARRIER();
+	return sreg;
+}
+
+/*
+ * Description:
+ * Restore SREG saved by SYNC_enterCritical(). The interrupts are enabled again only if they were enabled before.
+ */
+static inline void SYNC_exitCritical(uint8 a_sreg)
+{
+	SYNC_BARRIER();
+	SREG = a_sreg;
+}
+
+/*
+ * Description:
+ * Set the flag. One byte write, so it needs no critical section.
+ */
+static inline void SYNC_setFlag(SYNC_Flag *a_flag_ptr)
+{
+	*a_flag_ptr = TRUE;
+}
+
+/*
+ * Description:
+ * Return the flag value and clear it in the same critical section, so a set between the read and the clear is not lost.
+ */
+static inline uint8 SYNC_takeFlag(SYNC_Flag *a_flag_ptr)
+{
+	uint8 sreg = SYNC_enterCritical();
+	uint8 value = *a_flag_ptr;
+
+	*a_flag_ptr = FALSE;
+	SYNC_exitCritical(sreg);
+	return value;
+}
+
+/*
+ * Description:
+ * Read a 16-bit variable written by an ISR. The two bytes are read without an interrupt between them.
+ */
+static inline uint16 SYNC_readU16(const volatile uint16 *a_data_ptr)
+{
+	uint8 sreg = SYNC_enterCritical();
+	uint16 value = *a_data_ptr;
+
+	SYNC_exitCritical(sreg);
+	return value;
+}
+
+/*
+ * Description:
+ * Write a 16-bit variable read by an ISR. The two bytes are written without an interrupt between them.
+ */
+static inline void SYNC_writeU16(volatile uint16 *a_data_ptr, uint16 value)
+{
+	uint8 sreg = SYNC_enterCritical();
+
+	*a_data_ptr = value;
+	SYNC_exitCritical(sreg);
+}
+
+/*
+ * Description:
+ * Read a 32-bit variable written by an ISR. The four bytes are read without an interrupt between them.
+ */
+static inline uint32 SYNC_readU32(const volatile uint32 *a_data_ptr)
+{
+	uint8 sreg = SYNC_enterCritical();
+	uint32 value = *a_data_ptr;
+
+	SYNC_exitCritical(sreg);
+	return value;
+}
+
+/*
+ * Description:
+ * Write a 32-bit variable read by an ISR. The four bytes are written without an interrupt between them.
+ */
+static inline void SYNC_writeU32(volatile uint32 *a_data_ptr, uint32 value)
+{
+	uint8 sreg = SYNC_enterCritical();
+
+	*a_data_ptr = value;
+	SYNC_exitCritical(sreg);
+}
+
+#endif /* SYNC_H_ */
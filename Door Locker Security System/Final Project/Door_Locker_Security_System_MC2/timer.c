@@ -19,13 +19,14 @@
 #include <avr/interrupt.h>
 #include "common_macros.h"
 #include "gpio.h"
+#include "sync.h"
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 
 /* Global variables to hold the address of the call back function in the application */
-static volatile void (*g_callBackPtr)(void) = NULL_PTR;
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
 
 
 /******************************************************************************
@@ -41,8 +42,8 @@ void TIMER_init(TIMER0_ConfigType *config_ptr)
 	 								Timer0
 	 *************************************************************************/
 	TCCR0 |= (1<< FOC0); /* The FOC0 bit is only active when the WGM00 bit specifies a non-PWM mode */
-	/* Select wave generation mode */
-	TCCR0 = (TCCR0 & 0xB7) | ((((config_ptr->waveGenerationMode & 0x02)>>1)<<6) | ((config_ptr->waveGenerationMode & 0x01)<<3));
+	/* Select wave generation mode (WGM00 is bit 6 and WGM01 is bit 3, CTC mode is WGM01 = 1) */
+	TCCR0 = (TCCR0 & 0xB7) | (((config_ptr->waveGenerationMode & 0x01)<<6) | (((config_ptr->waveGenerationMode & 0x02)>>1)<<3));
 	/* Select Compare Match Output Mode*/
 	TCCR0 = (TCCR0 & 0xCF) | ((config_ptr->compareMatchOutputMode & 0x03)<<4);
 
@@ -62,8 +63,10 @@ void TIMER_init(TIMER0_ConfigType *config_ptr)
  */
 void TIMER_setCallBack(void(*a_ptr)(void))
 {
-	/* Save the address of the Call back function in a global variable */
+	/* Save the address of the Call back function in a global variable (two bytes, the ISR must not read half of it) */
+	uint8 sreg = SYNC_enterCritical();
 	g_callBackPtr = a_ptr;
+	SYNC_exitCritical(sreg);
 }
 
 /*
@@ -79,7 +82,7 @@ void TIMER_deinit(void)
 	TCNT0 = 0;
 	OCR0 = 0;
 	/* Disable interrupt for both normal and compare mode */
-	TIMSK &= ~(1<< TOIE0) & (1<< OCIE0);;
+	TIMSK &= ~((1<< TOIE0) | (1<< OCIE0));	/* Only the Timer0 bits, the other timers keep their interrupts */
 }
 
 /*******************************************************************************
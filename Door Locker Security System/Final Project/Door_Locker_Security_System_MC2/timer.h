@@ -18,6 +18,20 @@
  ******************************************************************************/
 #include "std_types.h"
 
+/******************************************************************************
+ *                                Definitions                                 *
+ ******************************************************************************/
+/*
+ * The main loop tick of MC2: Timer0 in overflow mode with F_CPU/1024, one tick each 1024 * 256 cycles
+ * (30.5 ticks each second at 8 MHz). Times are written in ms and converted here, so they follow F_CPU.
+ */
+#define TIMER_TICK_CYCLES				(1024UL * 256UL)
+#define TIMER_MS_TO_TICKS(ms)			(((((uint32)(ms)) * (F_CPU / 1000UL)) + (TIMER_TICK_CYCLES / 2)) / TIMER_TICK_CYCLES)
+#define TIMER_TICKS_PER_SECOND			TIMER_MS_TO_TICKS(1000)
+
+/* Whole seconds in a number of ticks, rounded up (a running time is never shown as zero). */
+#define TIMER_TICKS_TO_SECONDS(ticks)	(((((uint32)(ticks)) * (TIMER_TICK_CYCLES / 64UL)) + (F_CPU / 64UL) - 1) / (F_CPU / 64UL))
+
 /******************************************************************************
  *                         	   Types Declaration                              *
  ******************************************************************************/
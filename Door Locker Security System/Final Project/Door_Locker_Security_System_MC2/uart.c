@@ -18,6 +18,18 @@
 #include "common_macros.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include "ring_buffer.h"
+#include "sync.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Buffers between the UART interrupts and the application (used only if the interrupt is enabled) */
+RING_BUFFER_DEFINE(g_uartRxBuffer, UART_RX_BUFFER_SIZE);
+RING_BUFFER_DEFINE(g_uartTxBuffer, UART_TX_BUFFER_SIZE);
+
+static UART_RX_Interrupt_Enable g_uartRxInterrupt = RX_INTERRUPT_DISABLE;
+static UART_TX_Interrupt_Enable g_uartTxInterrupt = TX_INTERRUPT_DISABLE;
 
 
 /*******************************************************************************
@@ -42,15 +54,18 @@ void UART_init(uint32 a_bandRate, const UART_ConfigType *config_ptr)
 	 UCSRA = (UCSRA & 0xFD) | (config_ptr->transmissionSpeed << 1); /* transmission Speed select */
 
 	 /*
-	  * RX, TXCIE, and UDRIE are interrupt enable bits. not required since the use of polling.
+	  * RXCIE configured by the developer, the RX interrupt fills the receive buffer.
+	  * TXCIE = 0. With TX interrupt enabled, UDRIE is set only while the transmit buffer has data.
 	  * RXEN = 1, TXEN = 1. To enable Receiver and Transmitter.
 	  * RXB8 and TXB8 not required because no need for the ninth bit.
 	  * UCSZ2, configured by the developer, Character Size.
 	  */
+	 g_uartRxInterrupt = config_ptr->RXInterruptEnable;
+	 g_uartTxInterrupt = config_ptr->TXInterruptEnable;
 	 UCSRB |= (1<< RXEN) | (1<< TXEN);
 	 UCSRB = (UCSRB & 0xFB) | ((config_ptr->CharacterSize & 0x04>>2)<<2);/* select character size */
 	 UCSRB = (UCSRB & 0x7F) | (config_ptr->RXInterruptEnable<<7); /* RX Interrupt configure */
-	 UCSRB = (UCSRB & 0xBF) | (config_ptr->TXInterruptEnable<<6); /* TX Interrupt configure */
+	 UCSRB &= ~((1<<TXCIE) | (1<<UDRIE)); /* TX Interrupt is enabled later by UART_sendByte() */
 
 	/*
 	 * URSEL = 1,The URSEL must be one when writing the UCSRC.
@@ -85,23 +100,71 @@ void UART_init(uint32 a_bandRate, const UART_ConfigType *config_ptr)
  * Description:
  * wait until the UDR register is empty.
  * sent 8-bits data by put the data value in UDR register.
+ * If the TX interrupt is enabled, the data is added to the transmit buffer and sent by the interrupt,
+ * the function only waits if the buffer is full.
  */
 void UART_sendByte(const uint8 data)
 {
-	while(BIT_IS_CLEAR(UCSRA, UDRE)){}
-	UDR = data;
+	if(g_uartTxInterrupt == TX_INTERRUPT_ENABLE)
+	{
+		uint8 sreg;
+
+		while(RING_BUFFER_push(&g_uartTxBuffer, data) == FALSE){}
+
+		/* The interrupt sends the buffer and disables itself when the buffer is empty, so UCSRB is changed with the interrupts disabled */
+		sreg = SYNC_enterCritical();
+		SET_BIT(UCSRB, UDRIE);
+		SYNC_exitCritical(sreg);
+	}
+	else
+	{
+		while(BIT_IS_CLEAR(UCSRA, UDRE)){}
+		UDR = data;
+	}
 }
 
 /*
  * Description:
  * wait until the UDR register receive all 8-bits data.
  * Return this data to be saved in another variable.
+ * If the RX interrupt is enabled, the data is taken from the receive buffer filled by the interrupt.
  */
 uint8 UART_recieveByte(void)
 {
+	uint8 data;
+
+	if(g_uartRxInterrupt == RX_INTERRUPT_ENABLE)
+	{
+		while(RING_BUFFER_pop(&g_uartRxBuffer, &data) == FALSE){}
+		return data;
+	}
+
 	while(BIT_IS_CLEAR(UCSRA, RXC)){}
 	return UDR;
 }
+
+/*
+ * Description:
+ * Check without waiting if a new byte is received in the UDR register.
+ * Return TRUE if UART_recieveByte() can read it directly, FALSE otherwise.
+ */
+uint8 UART_isDataReceived(void)
+{
+	if(g_uartRxInterrupt == RX_INTERRUPT_ENABLE)
+	{
+		return !RING_BUFFER_isEmpty(&g_uartRxBuffer);
+	}
+
+	if(BIT_IS_SET(UCSRA, RXC))
+	{
+		return TRUE;
+	}
+	else
+	{
+		return FALSE;
+	}
+}
+
 /*
  * Description:
  * This function take a string in a pointer.
@@ -141,3 +204,25 @@ void UART_recieveString(uint8 *a_str_ptr)
 	a_str_ptr[i] = '\0';
 }
 
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(USART_RXC_vect)
+{
+	/* Reading UDR clears the interrupt flag, the byte is lost only if the application left the buffer full */
+	RING_BUFFER_push(&g_uartRxBuffer, UDR);
+}
+
+ISR(USART_UDRE_vect)
+{
+	uint8 data;
+
+	if(RING_BUFFER_pop(&g_uartTxBuffer, &data))
+	{
+		UDR = data;
+	}
+	else
+	{
+		CLEAR_BIT(UCSRB, UDRIE); /* Nothing left to send */
+	}
+}
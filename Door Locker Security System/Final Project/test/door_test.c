@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: door_test.c
+ *
+ * Description: Host simulation of the MC2 door limit switches and travel timeout.
+ *              The switches are driven through the PIN registers, a pressed switch reads low.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#include "test.h"
+#include "door.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                              Definitions                                    *
+ *******************************************************************************/
+#define DOOR0_OPEN_LIMIT_MASK			(1 << 3)		/* PD3 */
+#define DOOR0_CLOSED_LIMIT_MASK			(1 << 2)		/* PB2 */
+#define DOOR1_OPEN_LIMIT_MASK			(1 << 4)		/* PC4 */
+#define DOOR1_CLOSED_LIMIT_MASK			(1 << 5)		/* PC5 */
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Call DOOR_tick() the required number of times.
+ */
+static void tick(int ticks)
+{
+	while(ticks-- > 0)
+	{
+		DOOR_tick();
+	}
+}
+
+/*
+ * Description:
+ * Release all the switches (pull-ups read high).
+ */
+static void releaseSwitches(void)
+{
+	PINB = 0xFF;
+	PINC = 0xFF;
+	PIND = 0xFF;
+}
+
+int main(void)
+{
+	releaseSwitches();
+	DOOR_init();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_IDLE);
+	TEST_CHECK_EQUAL(DOOR_getState(1), DOOR_IDLE);
+
+	/* Door 0 opens until the open switch interrupt event, whatever the travel time. */
+	TEST_CHECK(DOOR_open(0));
+	TEST_CHECK(!DOOR_open(0));
+	tick(60);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+	PIND &= ~DOOR0_OPEN_LIMIT_MASK;
+	DOOR_limitEvent(GPIO_INT1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_HOLDING);
+	PIND |= DOOR0_OPEN_LIMIT_MASK;
+
+	/* The event of a released switch (bounce) does not end the travel. */
+	tick(DOOR_HOLD_TICKS);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_CLOSING);
+	DOOR_limitEvent(GPIO_INT2);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_CLOSING);
+
+	/* The closed switch is found by the level check of the next tick too. */
+	PINB &= ~DOOR0_CLOSED_LIMIT_MASK;
+	tick(1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_IDLE);
+	releaseSwitches();
+
+	/* No switch in DOOR_TRAVEL_TIMEOUT_TICKS is a fault, which only DOOR_clearFault() leaves. */
+	TEST_CHECK(!DOOR_clearFault(0));
+	TEST_CHECK(DOOR_open(0));
+	tick(DOOR_TRAVEL_TIMEOUT_TICKS - 1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+	tick(1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_FAULT);
+	TEST_CHECK(!DOOR_open(0));
+	tick(DOOR_TRAVEL_TIMEOUT_TICKS);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_FAULT);
+
+	/* Clearing the fault closes the door again, a failed close is a fault again. */
+	TEST_CHECK(DOOR_clearFault(0));
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_CLOSING);
+	tick(DOOR_TRAVEL_TIMEOUT_TICKS);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_FAULT);
+	TEST_CHECK(DOOR_clearFault(0));
+	PINB &= ~DOOR0_CLOSED_LIMIT_MASK;
+	tick(1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_IDLE);
+	releaseSwitches();
+
+	/* A re-open while closing runs until the open switch. */
+	TEST_CHECK(DOOR_open(0));
+	PIND &= ~DOOR0_OPEN_LIMIT_MASK;
+	tick(1);
+	PIND |= DOOR0_OPEN_LIMIT_MASK;
+	tick(DOOR_HOLD_TICKS + 20);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_CLOSING);
+	TEST_CHECK(DOOR_reopen(0));
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+	tick(DOOR_TRAVEL_TIMEOUT_TICKS - 1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+	PIND &= ~DOOR0_OPEN_LIMIT_MASK;
+	tick(1);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_HOLDING);
+	releaseSwitches();
+
+	/* Door 1 has no interrupt lines, its switches are polled each tick, and door 0 keeps its own cycle. */
+	TEST_CHECK(DOOR_open(1));
+	tick(5);
+	PINC &= ~DOOR1_OPEN_LIMIT_MASK;
+	DOOR_limitEvent(GPIO_INT1);
+	TEST_CHECK_EQUAL(DOOR_getState(1), DOOR_OPENING);
+	tick(1);
+	TEST_CHECK_EQUAL(DOOR_getState(1), DOOR_HOLDING);
+	PINC |= DOOR1_OPEN_LIMIT_MASK;
+	tick(DOOR_HOLD_TICKS);
+	TEST_CHECK_EQUAL(DOOR_getState(1), DOOR_CLOSING);
+	PINC &= ~DOOR1_CLOSED_LIMIT_MASK;
+	tick(1);
+	TEST_CHECK_EQUAL(DOOR_getState(1), DOOR_IDLE);
+
+	/* Doors that do not exist */
+	TEST_CHECK(!DOOR_open(DOOR_COUNT));
+	TEST_CHECK_EQUAL(DOOR_getState(DOOR_COUNT), DOOR_FAULT);
+
+	return TEST_end("door_test");
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: fake_eeprom.c
+ *
+ * Description: Host stand-in for the external EEPROM driver of MC2.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#include "fake_eeprom.h"
+#include "external_eeprom.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+uint8 g_fakeEeprom[FAKE_EEPROM_SIZE];
+uint16 g_fakeEepromWrites = 0;
+sint16 g_fakeEepromWritesLeft = -1;
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Erase the whole memory (all bytes 0xFF).
+ */
+void FAKE_EEPROM_erase(void)
+{
+	uint16 i;
+
+	for(i = 0; i < FAKE_EEPROM_SIZE; i++)
+	{
+		g_fakeEeprom[i] = 0xFF;
+	}
+	g_fakeEepromWrites = 0;
+	g_fakeEepromWritesLeft = -1;
+}
+
+uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
+{
+	if((u16addr >= FAKE_EEPROM_SIZE) || (g_fakeEepromWritesLeft == 0))
+	{
+		return ERROR;
+	}
+	if(g_fakeEepromWritesLeft > 0)
+	{
+		g_fakeEepromWritesLeft--;
+	}
+	g_fakeEeprom[u16addr] = u8data;
+	g_fakeEepromWrites++;
+	return SUCCESS;
+}
+
+uint8 EEPROM_writeByteWait(uint16 u16addr, uint8 u8data)
+{
+	return EEPROM_writeByte(u16addr, u8data);
+}
+
+uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
+{
+	if(u16addr >= FAKE_EEPROM_SIZE)
+	{
+		return ERROR;
+	}
+	*u8data = g_fakeEeprom[u16addr];
+	return SUCCESS;
+}
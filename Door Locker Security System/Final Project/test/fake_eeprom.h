@@ -0,0 +1,40 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: fake_eeprom.h
+ *
+ * Description: Host stand-in for the external EEPROM driver of MC2. The memory is an array the test
+ *              reads and copies to simulate a reset at any write.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef FAKE_EEPROM_H_
+#define FAKE_EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                              Definitions                                    *
+ *******************************************************************************/
+#define FAKE_EEPROM_SIZE				2048		/* 24C16 */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+extern uint8 g_fakeEeprom[FAKE_EEPROM_SIZE];
+extern uint16 g_fakeEepromWrites;				/* Number of bytes written since the last FAKE_EEPROM_erase(). */
+extern sint16 g_fakeEepromWritesLeft;			/* Writes that succeed before the memory fails (power cut), -1 for no limit. */
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+/*
+ * Description:
+ * Erase the whole memory (all bytes 0xFF).
+ */
+void FAKE_EEPROM_erase(void);
+
+#endif /* FAKE_EEPROM_H_ */
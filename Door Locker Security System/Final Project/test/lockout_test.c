@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: lockout_test.c
+ *
+ * Description: Host simulation of the MC2 password lockout. Each failure must be in the EEPROM when
+ *              LOCKOUT_recordFailure() returns, and a reset at any write must not give more tries.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#include "test.h"
+#include "fake_eeprom.h"
+#include "lockout.h"
+
+/*******************************************************************************
+ *                              Definitions                                    *
+ *******************************************************************************/
+#define FAILURES_ADDRESS				(LOCKOUT_EEPROM_ADDRESS + 0)
+#define LEVEL_ADDRESS					(LOCKOUT_EEPROM_ADDRESS + 1)
+#define LOCKED_ADDRESS					(LOCKOUT_EEPROM_ADDRESS + 2)
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Call LOCKOUT_tick() the required number of times.
+ */
+static void tick(long ticks)
+{
+	while(ticks-- > 0)
+	{
+		LOCKOUT_tick();
+	}
+}
+
+int main(void)
+{
+	uint8 failure;
+	sint16 cut;
+
+	FAKE_EEPROM_erase();
+	LOCKOUT_init();
+	tick(10);
+	TEST_CHECK(!LOCKOUT_isLocked());
+	TEST_CHECK_EQUAL(LOCKOUT_getRemainingSeconds(), 0);
+
+	/* Each failure is saved before the answer, without any tick. */
+	TEST_CHECK(!LOCKOUT_recordFailure());
+	TEST_CHECK_EQUAL(g_fakeEeprom[FAILURES_ADDRESS], 1);
+	TEST_CHECK(!LOCKOUT_recordFailure());
+	TEST_CHECK_EQUAL(g_fakeEeprom[FAILURES_ADDRESS], 2);
+
+	/* A reset after each write of the third failure: the doors are locked or the failures are still counted. */
+	for(cut = 0; cut <= LOCKOUT_EEPROM_RECORD_SIZE; cut++)
+	{
+		g_fakeEeprom[FAILURES_ADDRESS] = 2;
+		g_fakeEeprom[LEVEL_ADDRESS] = 0;
+		g_fakeEeprom[LOCKED_ADDRESS] = FALSE;
+		LOCKOUT_init();
+		g_fakeEepromWritesLeft = cut;
+		TEST_CHECK(LOCKOUT_recordFailure());
+		g_fakeEepromWritesLeft = -1;
+
+		LOCKOUT_init();
+		if(LOCKOUT_isLocked() == FALSE)
+		{
+			/* Nothing was written, the next wrong password still locks. */
+			TEST_CHECK_EQUAL(cut, 0);
+			TEST_CHECK(LOCKOUT_recordFailure());
+		}
+		TEST_CHECK(LOCKOUT_isLocked());
+	}
+
+	/* The lockout is 60 seconds, then the next one is twice as long. */
+	TEST_CHECK_EQUAL(LOCKOUT_getRemainingSeconds(), 60);
+	TEST_CHECK(!LOCKOUT_recordFailure());
+	tick(LOCKOUT_BASE_TICKS);
+	TEST_CHECK(!LOCKOUT_isLocked());
+	tick(10);
+	TEST_CHECK_EQUAL(g_fakeEeprom[LEVEL_ADDRESS], 1);
+	TEST_CHECK_EQUAL(g_fakeEeprom[LOCKED_ADDRESS], FALSE);
+	for(failure = 1; failure < LOCKOUT_MAX_FAILURES; failure++)
+	{
+		TEST_CHECK(!LOCKOUT_recordFailure());
+	}
+	TEST_CHECK(LOCKOUT_recordFailure());
+	TEST_CHECK_EQUAL(LOCKOUT_getRemainingSeconds(), 120);
+
+	/* A reset during the lockout starts it again. */
+	LOCKOUT_init();
+	TEST_CHECK(LOCKOUT_isLocked());
+	tick(2 * LOCKOUT_BASE_TICKS);
+	TEST_CHECK(!LOCKOUT_isLocked());
+
+	/* A correct password clears the failures and the level. */
+	TEST_CHECK(!LOCKOUT_recordFailure());
+	LOCKOUT_recordSuccess();
+	tick(10);
+	TEST_CHECK_EQUAL(g_fakeEeprom[FAILURES_ADDRESS], 0);
+	TEST_CHECK_EQUAL(g_fakeEeprom[LEVEL_ADDRESS], 0);
+
+	return TEST_end("lockout_test");
+}
@@ -0,0 +1,129 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: password_test.c
+ *
+ * Description: Host simulation of the two slot password record of MC2. A reset is simulated after
+ *              each EEPROM write of a password change: the saved or the new password must be found.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#include <string.h>
+#include "test.h"
+#include "fake_eeprom.h"
+#include "password.h"
+
+/*******************************************************************************
+ *                              Definitions                                    *
+ *******************************************************************************/
+#define WRITE_TICKS						100			/* More than the steps of one password write. */
+#define SEQUENCE_WRAP_SAVES				300			/* More than the 255 sequence values. */
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Call PASSWORD_tick() the required number of times.
+ */
+static void tick(int ticks)
+{
+	while(ticks-- > 0)
+	{
+		PASSWORD_tick();
+	}
+}
+
+int main(void)
+{
+	const uint8 passwordA[PASSWORD_SIZE] = {1, 2, 3, 4};
+	const uint8 passwordB[PASSWORD_SIZE] = {5, 6, 7, 8};
+	uint8 saved[FAKE_EEPROM_SIZE];
+	uint8 password[PASSWORD_SIZE];
+	uint16 writes;
+	uint16 cut;
+	int i;
+
+	/* A new device has no password. */
+	FAKE_EEPROM_erase();
+	PASSWORD_init();
+	TEST_CHECK(!PASSWORD_isSaved());
+
+	/* The first password is found after a reset. */
+	PASSWORD_saveMemory(passwordA);
+	tick(WRITE_TICKS);
+	PASSWORD_init();
+	TEST_CHECK(PASSWORD_isSaved());
+	TEST_CHECK(PASSWORD_compareFromMemory(passwordA));
+	TEST_CHECK(!PASSWORD_compareFromMemory(passwordB));
+
+	/* Count the writes of a change, then reset after each one of them. */
+	memcpy(saved, g_fakeEeprom, sizeof(saved));
+	g_fakeEepromWrites = 0;
+	PASSWORD_saveMemory(passwordB);
+	tick(WRITE_TICKS);
+	writes = g_fakeEepromWrites;
+	TEST_CHECK(writes > PASSWORD_RECORD_SIZE);
+
+	for(cut = 0; cut <= writes; cut++)
+	{
+		memcpy(g_fakeEeprom, saved, sizeof(saved));
+		PASSWORD_init();
+		PASSWORD_saveMemory(passwordB);
+		tick(cut);
+		PASSWORD_init();
+
+		/* Exactly one of them is the password, the old one until the new slot is complete. */
+		TEST_CHECK(PASSWORD_isSaved());
+		TEST_CHECK(PASSWORD_compareFromMemory(passwordA) != PASSWORD_compareFromMemory(passwordB));
+		if(cut <= PASSWORD_RECORD_SIZE + 1)
+		{
+			TEST_CHECK(PASSWORD_compareFromMemory(passwordA));
+		}
+		if(cut == writes)
+		{
+			TEST_CHECK(PASSWORD_compareFromMemory(passwordB));
+		}
+	}
+
+	/* A change that is cut and started again in the same slot. */
+	memcpy(g_fakeEeprom, saved, sizeof(saved));
+	PASSWORD_init();
+	PASSWORD_saveMemory(passwordB);
+	tick(10);
+	PASSWORD_saveMemory(passwordA);
+	tick(WRITE_TICKS);
+	PASSWORD_init();
+	TEST_CHECK(PASSWORD_compareFromMemory(passwordA));
+
+	/* The newest slot is found after the sequence byte wraps from 0xFE to 0. */
+	for(i = 0; i < SEQUENCE_WRAP_SAVES; i++)
+	{
+		password[0] = (uint8)(i % 10);
+		password[1] = (uint8)((i / 10) % 10);
+		password[2] = (uint8)((i / 100) % 10);
+		password[3] = 9;
+		PASSWORD_saveMemory(password);
+		tick(WRITE_TICKS);
+		PASSWORD_init();
+		TEST_CHECK(PASSWORD_compareFromMemory(password));
+	}
+
+	/* The plain password of the old versions is hashed into a slot, then erased. */
+	FAKE_EEPROM_erase();
+	for(i = 0; i < PASSWORD_SIZE; i++)
+	{
+		g_fakeEeprom[PASSWORD_OLD_EEPROM_ADDRESS + i] = passwordB[i];
+	}
+	PASSWORD_init();
+	TEST_CHECK(PASSWORD_compareFromMemory(passwordB));
+	tick(WRITE_TICKS);
+	TEST_CHECK_EQUAL(g_fakeEeprom[PASSWORD_OLD_EEPROM_ADDRESS], 0xFF);
+	PASSWORD_init();
+	TEST_CHECK(PASSWORD_compareFromMemory(passwordB));
+
+	return TEST_end("password_test");
+}
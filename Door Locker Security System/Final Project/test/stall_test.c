@@ -0,0 +1,156 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: stall_test.c
+ *
+ * Description: Host simulation of the MC2 motor stall detection. The motor current is written
+ *              to the ADC register and the ADC and Timer2 interrupts are called by the test.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#include "test.h"
+#include "door.h"
+#include "dc_motor.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                              Definitions                                    *
+ *******************************************************************************/
+#define DOOR0_OPEN_LIMIT_MASK			(1 << 3)		/* PD3 */
+#define DOOR0_CLOSED_LIMIT_MASK			(1 << 2)		/* PB2 */
+#define STALL_ADC_VALUE					300				/* About 3 A on the 0.5 ohm shunt. */
+#define RUNNING_ADC_VALUE				60				/* Normal running current. */
+#define FULL_RAMP_PERIODS				(DC_RAMP_PERIOD * 60)	/* More than the 51 ramp steps from stop to full speed. */
+
+/*
+ * The moving average needs a few samples to rise above the stall current, then DOOR_STALL_SAMPLES
+ * samples of each door are counted. The channels take turns, so each sample of door 0 is two ISRs.
+ */
+#define STALL_MAX_ISRS					((16 + DOOR_STALL_SAMPLES) * DOOR_COUNT)
+
+/*******************************************************************************
+ *                         	Function Prototypes                                *
+ *******************************************************************************/
+void ADC_vect(void);
+void TIMER2_OVF_vect(void);
+
+/*******************************************************************************
+ *                         	Function Deceleration                              *
+ *******************************************************************************/
+/*
+ * Description:
+ * Call DOOR_tick() the required number of times.
+ */
+static void tick(int ticks)
+{
+	while(ticks-- > 0)
+	{
+		DOOR_tick();
+	}
+}
+
+/*
+ * Description:
+ * Run the motor ramp for the required number of PWM periods.
+ */
+static void pwmPeriods(int periods)
+{
+	while(periods-- > 0)
+	{
+		TIMER2_OVF_vect();
+	}
+}
+
+/*
+ * Description:
+ * Convert the same current value the required number of times.
+ * Return the number of conversions until the motor of door 0 stopped, or 0 if it did not stop.
+ */
+static int adcSamples(int samples, uint16_t value)
+{
+	int i;
+
+	ADC = value;
+	for(i = 1; i <= samples; i++)
+	{
+		ADC_vect();
+		if(OCR2 == 0)
+		{
+			return i;
+		}
+	}
+	return 0;
+}
+
+int main(void)
+{
+	int isrs;
+
+	PINB = 0xFF;
+	PINC = 0xFF;
+	PIND = 0xFF;
+	DCMotor_init();
+	DOOR_init();
+
+	/* The start current is not checked during DOOR_STALL_BLANK_TICKS, it is back to normal before the check starts. */
+	TEST_CHECK(DOOR_open(0));
+	pwmPeriods(FULL_RAMP_PERIODS);
+	TEST_CHECK_EQUAL(OCR2, 255);
+	tick(DOOR_STALL_BLANK_TICKS - 1);
+	TEST_CHECK_EQUAL(adcSamples(200, STALL_ADC_VALUE), 0);
+	TEST_CHECK_EQUAL(adcSamples(200, RUNNING_ADC_VALUE), 0);
+	DOOR_poll();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+
+	/* A normal current after the blank time does not stop the motor. */
+	tick(1);
+	TEST_CHECK_EQUAL(adcSamples(200, RUNNING_ADC_VALUE), 0);
+	DOOR_poll();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+
+	/* A stall while opening stops the motor from the ISR, then DOOR_poll() latches a fault. */
+	isrs = adcSamples(200, STALL_ADC_VALUE);
+	printf("stall_test: motor stopped after %d ADC conversions\n", isrs);
+	TEST_CHECK(isrs > 0);
+	TEST_CHECK(isrs <= STALL_MAX_ISRS);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+	DOOR_poll();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_FAULT);
+
+	/* Clearing the fault closes the door before it can be opened again. */
+	TEST_CHECK(DOOR_clearFault(0));
+	PINB &= ~DOOR0_CLOSED_LIMIT_MASK;
+	tick(1);
+	PINB |= DOOR0_CLOSED_LIMIT_MASK;
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_IDLE);
+
+	/* A stall while closing is an obstruction, the door opens again. */
+	TEST_CHECK(DOOR_open(0));
+	PIND &= ~DOOR0_OPEN_LIMIT_MASK;
+	tick(1);
+	PIND |= DOOR0_OPEN_LIMIT_MASK;
+	tick(DOOR_HOLD_TICKS);
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_CLOSING);
+	pwmPeriods(FULL_RAMP_PERIODS);
+	tick(DOOR_STALL_BLANK_TICKS);
+	adcSamples(200, RUNNING_ADC_VALUE);
+	TEST_CHECK(adcSamples(200, STALL_ADC_VALUE) > 0);
+	DOOR_poll();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+
+	/* The re-open starts a new blank time, so its reversal current is not a stall. */
+	pwmPeriods(FULL_RAMP_PERIODS);
+	TEST_CHECK_EQUAL(adcSamples(200, STALL_ADC_VALUE), 0);
+	TEST_CHECK_EQUAL(adcSamples(200, RUNNING_ADC_VALUE), 0);
+	tick(DOOR_STALL_BLANK_TICKS);
+	DOOR_poll();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_OPENING);
+	TEST_CHECK(adcSamples(200, STALL_ADC_VALUE) > 0);
+	DOOR_poll();
+	TEST_CHECK_EQUAL(DOOR_getState(0), DOOR_FAULT);
+
+	return TEST_end("stall_test");
+}
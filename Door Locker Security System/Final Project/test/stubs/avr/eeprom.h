@@ -0,0 +1,28 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: eeprom.h
+ *
+ * Description: Host stand-in for <avr/eeprom.h>, declarations only: it is used to compile the link
+ *              for the RAM estimate, no test links it.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_EEPROM_H_
+#define STUB_AVR_EEPROM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define EEMEM
+
+uint8_t eeprom_read_byte(const uint8_t *address);
+uint32_t eeprom_read_dword(const uint32_t *address);
+void eeprom_read_block(void *destination, const void *source, size_t size);
+void eeprom_update_byte(uint8_t *address, uint8_t value);
+void eeprom_update_dword(uint32_t *address, uint32_t value);
+
+#endif /* STUB_AVR_EEPROM_H_ */
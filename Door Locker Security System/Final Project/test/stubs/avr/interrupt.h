@@ -0,0 +1,21 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: interrupt.h
+ *
+ * Description: Host stand-in for <avr/interrupt.h>. An ISR becomes a plain function the test calls
+ *              to simulate the interrupt, e.g. ADC_vect().
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_INTERRUPT_H_
+#define STUB_AVR_INTERRUPT_H_
+
+#define ISR(vector)		void vector(void); void vector(void)
+#define sei()			do{}while(0)
+#define cli()			do{}while(0)
+
+#endif /* STUB_AVR_INTERRUPT_H_ */
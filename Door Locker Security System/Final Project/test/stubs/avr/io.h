@@ -0,0 +1,120 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: io.h
+ *
+ * Description: Host stand-in for <avr/io.h>. The ATmega16 registers are plain variables
+ *              (defined in registers.c), so a test writes PINx and reads PORTx/OCRx directly.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_IO_H_
+#define STUB_AVR_IO_H_
+
+#include <stdint.h>
+
+#define STUB_REGISTER(name)		extern volatile uint8_t name;
+#include "registers.def"
+#undef STUB_REGISTER
+
+extern volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1, ADC, ADCW;
+
+#define FOC0 7
+#define WGM00 6
+#define COM01 5
+#define COM00 4
+#define WGM01 3
+#define CS02 2
+#define CS01 1
+#define CS00 0
+#define OCIE2 7
+#define TOIE2 6
+#define TICIE1 5
+#define OCIE1A 4
+#define OCIE1B 3
+#define TOIE1 2
+#define OCIE0 1
+#define TOIE0 0
+#define FOC2 7
+#define WGM20 6
+#define COM21 5
+#define COM20 4
+#define WGM21 3
+#define CS22 2
+#define CS21 1
+#define CS20 0
+#define COM1A1 7
+#define COM1A0 6
+#define COM1B1 5
+#define COM1B0 4
+#define FOC1A 3
+#define FOC1B 2
+#define WGM11 1
+#define WGM10 0
+#define ICNC1 7
+#define ICES1 6
+#define WGM13 4
+#define WGM12 3
+#define CS12 2
+#define CS11 1
+#define CS10 0
+#define RXC 7
+#define TXC 6
+#define UDRE 5
+#define FE 4
+#define DOR 3
+#define PE 2
+#define U2X 1
+#define RXCIE 7
+#define TXCIE 6
+#define UDRIE 5
+#define RXEN 4
+#define TXEN 3
+#define UCSZ2 2
+#define URSEL 7
+#define TWINT 7
+#define TWEA 6
+#define TWSTA 5
+#define TWSTO 4
+#define TWEN 2
+#define TWIE 0
+#define REFS1 7
+#define REFS0 6
+#define ADLAR 5
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+#define ADTS2 7
+#define ADTS1 6
+#define ADTS0 5
+#define INT1 7
+#define INT0 6
+#define INT2 5
+#define INTF1 7
+#define INTF0 6
+#define INTF2 5
+#define ISC11 3
+#define ISC10 2
+#define ISC01 1
+#define ISC00 0
+#define ISC2 6
+#define JTD 7
+#define SREG_I 7
+#define PA0 0
+#define PB2 2
+#define PB3 3
+#define PD2 2
+#define PD3 3
+#define PD5 5
+#define PD7 7
+#define TOV2 6
+
+#endif /* STUB_AVR_IO_H_ */
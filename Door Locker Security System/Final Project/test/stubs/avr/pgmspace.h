@@ -0,0 +1,27 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: pgmspace.h
+ *
+ * Description: Host stand-in for <avr/pgmspace.h>, the program memory is ordinary memory on the host.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef STUB_AVR_PGMSPACE_H_
+#define STUB_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#ifndef PROGMEM
+#define PROGMEM											/* The RAM estimate of the makefile puts it in a section of its own. */
+#endif
+#define PSTR(s)					(s)
+#define pgm_read_byte(address)	(*(const uint8_t *)(address))
+#define pgm_read_word(address)	(*(const uint16_t *)(address))
+#define pgm_read_dword(address)	(*(const uint32_t *)(address))
+#define pgm_read_ptr(address)	(*(void * const *)(address))
+
+#endif /* STUB_AVR_PGMSPACE_H_ */
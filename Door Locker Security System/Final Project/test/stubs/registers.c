@@ -0,0 +1,19 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: registers.c
+ *
+ * Description: The ATmega16 registers of the host stand-in for <avr/io.h>.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#include <avr/io.h>
+
+#define STUB_REGISTER(name)		volatile uint8_t name;
+#include "avr/registers.def"
+#undef STUB_REGISTER
+
+volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1, ADC, ADCW;
@@ -0,0 +1,45 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: std_types.h
+ *
+ * Description: Host version of std_types.h with the AVR sizes (32-bit uint32), included before
+ *              every source by the makefile, so the std_types.h of the project is skipped.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef STD_TYPES_
+#define STD_TYPES_
+
+#include <stdint.h>
+
+typedef unsigned char boolean;
+
+#ifndef TRUE
+#define TRUE   (1u)
+#endif
+
+#ifndef FALSE
+#define FALSE  (0u)
+#endif
+
+#define LOGIC_HIGH  (1u)
+#define LOGIC_LOW   (0u)
+
+#define NULL_PTR  ((void*)0)
+
+typedef uint8_t              uint8;
+typedef int8_t               sint8;
+typedef uint16_t             uint16;
+typedef int16_t              sint16;
+typedef uint32_t             uint32;
+typedef int32_t              sint32;
+typedef uint64_t             uint64;
+typedef int64_t              sint64;
+typedef float                float32;
+typedef double               float64;
+
+#endif /*STD_TYPES_*/
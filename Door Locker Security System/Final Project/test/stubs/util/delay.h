@@ -0,0 +1,19 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: delay.h
+ *
+ * Description: Host stand-in for <util/delay.h>, the busy waits return at once.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef STUB_UTIL_DELAY_H_
+#define STUB_UTIL_DELAY_H_
+
+static inline void _delay_ms(double ms) { (void)ms; }
+static inline void _delay_us(double us) { (void)us; }
+
+#endif /* STUB_UTIL_DELAY_H_ */
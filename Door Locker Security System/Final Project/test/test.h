@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ * Module: TEST
+ *
+ * File Name: test.h
+ *
+ * Description: Checks of the host simulations. Each failed check is printed and counted,
+ *              TEST_end() returns the exit code of the test program.
+ *
+ * Author: Abdelrahman Ehab
+ *
+ *******************************************************************************/
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static int g_testFailures = 0;
+
+/*******************************************************************************
+ *                              Definitions                                    *
+ *******************************************************************************/
+#define TEST_CHECK(condition)																\
+	do																						\
+	{																						\
+		if(!(condition))																	\
+		{																					\
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);			\
+			g_testFailures++;																\
+		}																					\
+	}while(0)
+
+#define TEST_CHECK_EQUAL(actual, expected)													\
+	do																						\
+	{																						\
+		long a_value = (long)(actual);														\
+		long e_value = (long)(expected);													\
+		if(a_value != e_value)																\
+		{																					\
+			printf("%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__, #actual, a_value, e_value);	\
+			g_testFailures++;																\
+		}																					\
+	}while(0)
+
+/*
+ * Description:
+ * Print the result of the test program and return its exit code.
+ */
+static inline int TEST_end(const char *name)
+{
+	printf("%s: %s\n", name, (g_testFailures == 0) ? "passed" : "FAILED");
+	return (g_testFailures == 0) ? 0 : 1;
+}
+
+#endif /* TEST_H_ */
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+#
+# Module: LINK
+#
+# File Name: make_link_key.py
+#
+# Description: Make the pre-shared key of one MC1/MC2 pair as an Intel HEX file for the internal EEPROM
+#              (LINK_KEY_EEPROM_ADDRESS of link.h). The same file is written to both ECUs of the pair.
+#              The key is random for each pair and is never kept in git.
+#
+# Author: Abdelrahman Ehab
+#
+
+import os
+import secrets
+import sys
+
+LINK_KEY_EEPROM_ADDRESS = 0x0000    # Same as link.h
+LINK_KEY_SIZE = 32                  # CHACHA20_KEY_SIZE
+RECORD_SIZE = 16                    # Data bytes in each HEX record
+
+
+def hex_record(address, record_type, data):
+    record = bytes([len(data), (address >> 8) & 0xFF, address & 0xFF, record_type]) + data
+    checksum = (-sum(record)) & 0xFF
+    return ":" + (record + bytes([checksum])).hex().upper() + "\n"
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: make_link_key.py <output.eep>")
+    path = sys.argv[1]
+
+    # A second call (from the other project) must not make a different key for the same pair.
+    if os.path.exists(path):
+        print(path + " already exists, it is kept. Delete it to make a key for a new pair.")
+        return
+
+    key = secrets.token_bytes(LINK_KEY_SIZE)
+    lines = [hex_record(LINK_KEY_EEPROM_ADDRESS + i, 0x00, key[i:i + RECORD_SIZE])
+             for i in range(0, LINK_KEY_SIZE, RECORD_SIZE)]
+    lines.append(hex_record(0, 0x01, b""))
+
+    # Only the owner can read the key.
+    fd = os.open(path, os.O_WRONLY | os.O_CREAT | os.O_EXCL, 0o600)
+    with os.fdopen(fd, "w") as output:
+        output.writelines(lines)
+    print("Wrote a new link key to " + path)
+
+
+if __name__ == "__main__":
+    main()